@@ -1,25 +1,33 @@
 #include "Aquarium.h"
+#include "WorkerPool.h"
 #include <cstdlib>
+#include <cstring>
 
 
 string AquariumCreatureTypeToString(AquariumCreatureType t){
-    switch(t){
-        case AquariumCreatureType::BiggerFish:
-            return "BiggerFish";
-        case AquariumCreatureType::NPCreature:
-            return "BaseFish";
-        case AquariumCreatureType::Crab:
-            return "Crab";
-        case AquariumCreatureType::Predator:
-            return "Predator";
-        default:
-            return "UknownFish";
+    if(size_t(t) >= CreatureArchetypeCount){
+        return "UknownFish";
     }
+    return GetArchetype(t).name;
+}
+
+bool AquariumCreatureTypeFromString(const std::string& name, AquariumCreatureType& out){
+    if(name == "BaseFish"){ // older name for the small fish
+        out = AquariumCreatureType::NPCreature;
+        return true;
+    }
+    for (const CreatureArchetype& archetype : CreatureArchetypes) {
+        if (archetype.kind != CreatureKind::PredatorPart && name == archetype.name) {
+            out = archetype.type;
+            return true;
+        }
+    }
+    return false;
 }
 
 // PlayerCreature Implementation
-PlayerCreature::PlayerCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
-: Creature(x, y, speed, 10.0f, 1, sprite) {
+PlayerCreature::PlayerCreature(float x, float y, int speed, SpriteId sprite)
+: Creature(x, y, speed, sprite) {
     m_base_speed_backup = speed; // We need a copy of the original speed value
 }
 
@@ -30,15 +38,12 @@ void PlayerCreature::setDirection(float dx, float dy) {
     normalize();
 }
 
-void PlayerCreature::move() {
-    this->bounce();
-    m_x += m_dx * m_speed;
-    m_y += m_dy * m_speed;
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
+void PlayerCreature::move(const WorldContext& world) {
+    this->bounce(world);
+    const float speed = m_sprinting ? m_speed * SprintFactor : m_speed;
+    m_x += m_dx * speed;
+    m_y += m_dy * speed;
+    this->setFlipped(m_dx < 0);
 }
 
 void PlayerCreature::reduceDamageDebounce() {
@@ -47,7 +52,11 @@ void PlayerCreature::reduceDamageDebounce() {
     }
 }
 
-void PlayerCreature::update() {
+PlayerSnapshot PlayerCreature::snapshot() const {
+    return PlayerSnapshot{m_x, m_y, m_dx, m_dy, m_power, true};
+}
+
+void PlayerCreature::update(const WorldContext& world) {
     this->reduceDamageDebounce();
 
     // Handling speed boost timer
@@ -55,11 +64,11 @@ void PlayerCreature::update() {
         --m_speed_boost_frames_left;
         if (m_speed_boost_frames_left == 0) {
             // If the m_base_speed_backup is greater than 0, use m_base_speed_backup. Otherwise just use m_speed.
-            m_speed = (m_base_speed_backup > 0) ? m_base_speed_backup : m_speed;
+            this->setSpeed((m_base_speed_backup > 0) ? m_base_speed_backup : m_speed);
         }
     }
 
-    this->move();
+    this->move(world);
 }
 
 
@@ -67,19 +76,20 @@ void PlayerCreature::draw() const {
     
     ofLogVerbose() << "PlayerCreature at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
     if (m_damage_debounce > 0) { // Flashes red for a more fancy damage debounce visual
+        // the debounce counts ticks down, so it doubles as the flash clock
         float flashSpeed = 10.0f;
-        float intensity = (sin(ofGetElapsedTimef() * flashSpeed) * 0.5f + 0.5f); // 0–1
+        float intensity = (sin(m_damage_debounce / AnimationTable::TicksPerSecond * flashSpeed) * 0.5f + 0.5f); // 0–1
         ofSetColor(255, 255 * (1 - intensity), 255 * (1 - intensity)); // fade red
     }
-    if (m_sprite) {
-        m_sprite->draw(m_x, m_y);
+    if (const GameSprite* sprite = this->sprite()) {
+        sprite->draw(m_x, m_y, m_flipped);
     }
     ofSetColor(ofColor::white); // Reset color
 
 }
 
 void PlayerCreature::changeSpeed(int speed) {
-    m_speed = speed;
+    this->setSpeed(speed);
 }
 
 void PlayerCreature::loseLife(int debounce) {
@@ -96,63 +106,46 @@ void PlayerCreature::loseLife(int debounce) {
 
 void PlayerCreature::applySpeedBoost(float factor, int durationFrames) {
     if (m_base_speed_backup == 0) m_base_speed_backup = m_speed; // We'll store the original speed values here
-    m_speed = std::max(1, int(std::round(m_base_speed_backup * factor)));
+    this->setSpeed(std::max(1, int(std::round(m_base_speed_backup * factor))));
     m_speed_boost_frames_left = durationFrames;
 }
 
-// NPCreature Implementation
-NPCreature::NPCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
-: Creature(x, y, speed, 30, 1, sprite) {
-    m_dx = (rand() % 3 - 1); // -1, 0, or 1
-    m_dy = (rand() % 3 - 1); // -1, 0, or 1
-    normalize();
+PlayerProgress PlayerCreature::getProgress() const {
+    return PlayerProgress{m_score, m_lives, m_power, m_damage_debounce, m_base_speed_backup, m_speed_boost_frames_left};
+}
 
-    m_creatureType = AquariumCreatureType::NPCreature;
+void PlayerCreature::setProgress(const PlayerProgress& progress) {
+    m_score = progress.score;
+    m_lives = progress.lives;
+    m_power = progress.power;
+    m_damage_debounce = progress.damageDebounce;
+    m_base_speed_backup = progress.baseSpeed;
+    m_speed_boost_frames_left = progress.speedBoostFramesLeft;
 }
 
-void NPCreature::move() {
-    // Simple AI movement logic (random direction)
-    m_x += m_dx * m_speed;
-    m_y += m_dy * m_speed;
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
-    bounce();
+// NPCreature Implementation
+NPCreature::NPCreature(AquariumCreatureType type, float x, float y, int speed, SpriteId sprite, GameRng& rng)
+: Creature(x, y, speed, sprite) {
+    m_dx = (GameRandom::Below(rng, 3) - 1); // -1, 0, or 1
+    m_dy = (GameRandom::Below(rng, 3) - 1); // -1, 0, or 1
+    normalize();
+
+    m_creatureType = uint16_t(type);
 }
 
 void NPCreature::draw() const {
     ofLogVerbose() << "NPCreature at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
     ofSetColor(ofColor::white);
-    if (m_sprite) {
-        m_sprite->draw(m_x, m_y);
+    if (const GameSprite* sprite = this->sprite()) {
+        sprite->draw(m_x, m_y, m_flipped);
     }
 }
 
-int NPCreature::getPlayerX() {
-    auto player = GetPlayer();
-    if (!player) {
-        ofLogError() << "Player not set yet!";
-        return 0;
-    }
-    return player->getX();
-}
-
-int NPCreature::getPlayerY() {
-    auto player = GetPlayer();
-    if (!player) {
-        ofLogError() << "Player not set yet!";
-        return 0;
-    }
-    return player->getY();
-}
-
-int NPCreature::getPlayerDirection() {
-    if (getPlayerX() > getX()) {
+int NPCreature::getPlayerDirection(const WorldContext& world) const {
+    if (world.player.x > getX()) {
         return 1;
     }
-    else if (getPlayerX() < getX()) {
+    else if (world.player.x < getX()) {
         return -1;
     }
     else {
@@ -160,120 +153,82 @@ int NPCreature::getPlayerDirection() {
     }
 }
 
-Crab::Crab(float x, float aquariumHeight, int speed, std::shared_ptr<GameSprite> sprite)
-: GroundCreature(x, aquariumHeight, speed, sprite) {
-    m_dx = (rand() % 2 == 0) ? 1 : -1;
-
-    setCollisionRadius(60);
-    m_value = 5;
-    m_creatureType = AquariumCreatureType::Crab;
-}
-
-void Crab::move() {
-
-    m_x += m_dx * m_speed; // Moves at half speed
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
-
-    bounce();
-}
-
-void Crab::draw() const {
-    ofLogVerbose() << "Crab at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
-    this->m_sprite->draw(this->m_x, this->m_y);
-}
-
-BiggerFish::BiggerFish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite)
-: NPCreature(x, y, speed, sprite) {
-    m_dx = (rand() % 3 - 1);
-    m_dy = (rand() % 3 - 1);
-    normalize();
-
-    setCollisionRadius(60); // Bigger fish have a larger collision radius
-    m_value = 5; // Bigger fish have a higher value
-    m_creatureType = AquariumCreatureType::BiggerFish;
+Predator::Predator(AquariumCreatureType type, float x, float y, int speed,
+                   SpriteId headSprite,
+                   SpriteId bodySprite,
+                   SpriteId tailSprite,
+                   std::shared_ptr<PredatorChainPool> chainPool,
+                   GameRng& rng)
+: NPCreature(type, x, y, speed, headSprite, rng),
+  m_chainPool(std::move(chainPool)),
+  m_bodySprite(bodySprite),
+  m_tailSprite(tailSprite)
+{
+    // head + body + tail all live in the shared pool
+    m_chain = m_chainPool->Allocate(GetArchetype(type).bodySegments + 2, x, y, SegmentSpacing);
 }
 
-void BiggerFish::move() {
-    // Bigger fish might move slower or have different logic
-    m_x += m_dx * (m_speed * 0.5); // Moves at half speed
-    m_y += m_dy * (m_speed * 0.5);
-    if(m_dx < 0 ){
-        this->m_sprite->setFlipped(true);
-    }else {
-        this->m_sprite->setFlipped(false);
-    }
-
-    bounce();
+Predator::~Predator() {
+    m_chainPool->Release(m_chain);
 }
 
-void BiggerFish::draw() const {
-    ofLogVerbose() << "BiggerFish at (" << m_x << ", " << m_y << ") with speed " << m_speed << std::endl;
-    this->m_sprite->draw(this->m_x, this->m_y);
+void Predator::releaseSegments() {
+    m_chainPool->Release(m_chain);
+    m_chain = PredatorChainPool::InvalidChain;
 }
 
-Predator::Predator(float x, float y, int speed,
-                   std::shared_ptr<GameSprite> headSprite,
-                   std::shared_ptr<GameSprite> bodySprite,
-                   std::shared_ptr<GameSprite> tailSprite,
-                   int segmentCount)
-: NPCreature(x, y, speed, headSprite),
-  m_bodySprite(bodySprite),
-  m_tailSprite(tailSprite)
-{
-    m_segments.resize(segmentCount + 2);
-    for (int i = 0; i < m_segments.size(); ++i) {
-        m_segments[i].position.set(x - i * m_segmentDistance, y);
+void Predator::restoreSegments(const float* xs, const float* ys, int count) {
+    if (count <= 0) { return; }
+    if (getSegments().size() != size_t(count)) {
+        m_chainPool->Release(m_chain);
+        m_chain = m_chainPool->Allocate(count, xs[0], ys[0], SegmentSpacing);
     }
-
-    m_dx = (rand() % 3 - 1);
-    m_dy = (rand() % 3 - 1);
-    normalize();
-
-    setCollisionRadius(40);
-    m_value = 10;
-    m_creatureType = AquariumCreatureType::Predator;
+    m_chainPool->Write(m_chain, xs, ys, count);
+    m_x = xs[0];
+    m_y = ys[0];
 }
 
 void Predator::draw() const {
-    if (!m_sprite || !m_bodySprite || !m_tailSprite) return;
+    const GameSprite* head = this->sprite();
+    const GameSprite* body = SpriteTable::Get(m_bodySprite);
+    const GameSprite* tail = SpriteTable::Get(m_tailSprite);
+    if (!head || !body || !tail) return;
+
+    ChainView segments = getSegments();
 
     // HEAD rotation (facing the next segment)
-    if (m_segments.size() >= 2) {
+    if (segments.size() >= 2) {
         float angle = atan2(
-            m_segments[1].position.y - m_segments[0].position.y,
-            m_segments[1].position.x - m_segments[0].position.x
+            segments.y(1) - segments.y(0),
+            segments.x(1) - segments.x(0)
         );
-        m_sprite->drawRot(m_segments[0].position.x, m_segments[0].position.y, ofRadToDeg(angle) - 90);
+        head->drawRot(segments.x(0), segments.y(0), ofRadToDeg(angle) - 90, m_flipped);
     }
 
     // BODY segments
-    for (size_t i = 1; i + 1 < m_segments.size(); ++i) {
+    for (size_t i = 1; i + 1 < segments.size(); i += m_drawStep) {
         float angle = atan2(
-            m_segments[i + 1].position.y - m_segments[i].position.y,
-            m_segments[i + 1].position.x - m_segments[i].position.x
+            segments.y(i + 1) - segments.y(i),
+            segments.x(i + 1) - segments.x(i)
         );
-        m_bodySprite->drawRot(m_segments[i].position.x, m_segments[i].position.y, ofRadToDeg(angle) - 90);
+        body->drawRot(segments.x(i), segments.y(i), ofRadToDeg(angle) - 90, m_flipped);
     }
 
     // TAIL rotation (facing previous segment)
-    if (m_segments.size() >= 2) {
-        size_t last = m_segments.size() - 1;
+    if (segments.size() >= 2) {
+        size_t last = segments.size() - 1;
         float angle = atan2(
-            m_segments[last - 1].position.y - m_segments[last].position.y,
-            m_segments[last - 1].position.x - m_segments[last].position.x
+            segments.y(last - 1) - segments.y(last),
+            segments.x(last - 1) - segments.x(last)
         );
-        m_tailSprite->drawRot(m_segments[last].position.x, m_segments[last].position.y, ofRadToDeg(angle) + 90);
+        tail->drawRot(segments.x(last), segments.y(last), ofRadToDeg(angle) + 90, m_flipped);
     }
 }
 
-void Predator::move() {
+void Predator::move(const WorldContext& world) {
 
-    ofVec2f playerPos(getPlayerX(), getPlayerY());
-    ofVec2f headPos = m_segments[0].position;
+    ofVec2f playerPos(world.player.x, world.player.y);
+    ofVec2f headPos(m_x, m_y);
 
     // direction to player
     ofVec2f dir = playerPos - headPos;
@@ -281,7 +236,7 @@ void Predator::move() {
     if (len > 0.0001f) dir.normalize();
 
     // add a subtle sine-wave wobble (so it "curls")
-    float t = ofGetElapsedTimef();
+    float t = world.time;
     float angleOffset = sin(t * 4.0f) * 0.5f; // tune freq & magnitude
     float c = cos(angleOffset);
     float s = sin(angleOffset);
@@ -290,84 +245,89 @@ void Predator::move() {
 
     // move head toward player
     float headSpeed = std::max(0.0f, static_cast<float>(m_speed) * 2); // tune multiplier
-    m_segments[0].position += rotatedDir * headSpeed;
+    headPos += rotatedDir * headSpeed;
 
-    // each segment follows the previous one, maintaining segment distance
-    for (size_t i = 1; i < m_segments.size(); ++i) {
-        ofVec2f delta = m_segments[i - 1].position - m_segments[i].position;
-        float dist = delta.length();
-        if (dist > 0.0001f) {
-            delta.normalize();
-            // move so the gap becomes segmentDistance (smooth trailing)
-            m_segments[i].position += delta * (dist - m_segmentDistance);
-        }
-    }
+    // only the head moves here, the body follows when Aquarium::update
+    // solves every chain in the pool at once
+    m_chainPool->SetHead(m_chain, headPos.x, headPos.y);
 
     // sync base Creature position with head for collisions/logic
-    this->m_x = m_segments[0].position.x;
-    this->m_y = m_segments[0].position.y;
+    this->m_x = headPos.x;
+    this->m_y = headPos.y;
 
     // Optionally update sprite flip based on movement direction:
-    if (rotatedDir.x < 0) this->m_sprite->setFlipped(true);
-    else this->m_sprite->setFlipped(false);
+    this->setFlipped(rotatedDir.x < 0);
 }
 
 
 // AquariumSpriteManager
 AquariumSpriteManager::AquariumSpriteManager(){
-    this->m_player_fish = std::make_shared<GameSprite>("player1.png", 40,40);
-    this->m_bigplayer_fish = std::make_shared<GameSprite>("player2.png", 40,40);
-    this->m_biggerplayer_fish = std::make_shared<GameSprite>("player3.png", 100,100);
-
-    this->m_npc_fish = std::make_shared<GameSprite>("base-fish.png", 70,70);
-    this->m_big_fish = std::make_shared<GameSprite>("bigger-fish.png", 120, 120);
-    this->m_crab_fish = std::make_shared<GameSprite>("crab.png", 50, 50);
-    this->m_predator_head = std::make_shared<GameSprite>("predator-head.png", 50, 50);
-    this->m_predator_body = std::make_shared<GameSprite>("predator-body.png", 50, 50);
-    this->m_predator_tail = std::make_shared<GameSprite>("predator-tail.png", 50, 50);
-}
-
-std::shared_ptr<GameSprite> AquariumSpriteManager::GetSprite(AquariumCreatureType t){
-    switch(t){
-        case AquariumCreatureType::BiggerFish:
-            return std::make_shared<GameSprite>(*this->m_big_fish);
-        case AquariumCreatureType::NPCreature:
-            return std::make_shared<GameSprite>(*this->m_npc_fish);
-        case AquariumCreatureType::Crab:
-            return std::make_shared<GameSprite>(*this->m_crab_fish);
-        case AquariumCreatureType::Predator:
-            return std::make_shared<GameSprite>(*this->m_predator_head);
-        case AquariumCreatureType::PredatorBody:
-            return std::make_shared<GameSprite>(*this->m_predator_body);
-        case AquariumCreatureType::PredatorTail:
-            return std::make_shared<GameSprite>(*this->m_predator_tail);
-        default:
-            return nullptr;
-    }
-}
-
-std::shared_ptr<GameSprite> AquariumSpriteManager::GetPlayerSprite(PlayerType t) {
+    this->m_player_fish = SpriteTable::Add(std::make_shared<GameSprite>("player1.png", 40,40));
+    this->m_bigplayer_fish = SpriteTable::Add(std::make_shared<GameSprite>("player2.png", 40,40));
+    this->m_biggerplayer_fish = SpriteTable::Add(std::make_shared<GameSprite>("player3.png", 100,100));
+
+    for (const CreatureArchetype& archetype : CreatureArchetypes) {
+        if (!archetype.spriteFile) { continue; }
+        SpriteId& sprite = this->m_creatureSprites[size_t(archetype.type)];
+        // rows can share an image (baby predators use the adult head), load it once
+        for (const CreatureArchetype& earlier : CreatureArchetypes) {
+            if (&earlier == &archetype) { break; }
+            if (earlier.spriteFile && std::strcmp(earlier.spriteFile, archetype.spriteFile) == 0) {
+                sprite = this->m_creatureSprites[size_t(earlier.type)];
+                break;
+            }
+        }
+        if (!sprite) {
+            sprite = SpriteTable::Add(std::make_shared<GameSprite>(archetype.spriteFile, archetype.spriteSize, archetype.spriteSize));
+        }
+    }
+
+    // animations.xml names them after the archetype rows, missing ones keep the sprite
+    for (const CreatureArchetype& archetype : CreatureArchetypes) {
+        this->m_creatureAnimations[size_t(archetype.type)] = AnimationTable::Find(archetype.name);
+    }
+}
+
+SpriteId AquariumSpriteManager::GetSprite(AquariumCreatureType t) const {
+    if (size_t(t) >= CreatureArchetypeCount) {
+        return 0;
+    }
+    return this->m_creatureSprites[size_t(t)];
+}
+
+AnimationId AquariumSpriteManager::GetAnimation(AquariumCreatureType t) const {
+    if (size_t(t) >= CreatureArchetypeCount) {
+        return 0;
+    }
+    return this->m_creatureAnimations[size_t(t)];
+}
+
+SpriteId AquariumSpriteManager::GetPlayerSprite(PlayerType t) const {
     switch (t){
         case PlayerType::Pirahna:
-            return std::make_shared<GameSprite>(*this->m_player_fish);
+            return this->m_player_fish;
         case PlayerType::Shark:
-            return std::make_shared<GameSprite>(*this->m_bigplayer_fish);
+            return this->m_bigplayer_fish;
         case PlayerType::Whale:
-            return std::make_shared<GameSprite>(*this->m_biggerplayer_fish);
+            return this->m_biggerplayer_fish;
     }
+    return 0;
 }
 
 // Aquarium Implementation
 Aquarium::Aquarium(int width, int height, std::shared_ptr<AquariumSpriteManager> spriteManager)
     : m_width(width), m_height(height) {
         m_sprite_manager =  spriteManager;
+        m_chainPool = std::make_shared<PredatorChainPool>();
     }
 
 
 
 void Aquarium::addCreature(std::shared_ptr<Creature> creature) {
-    creature->setBounds(m_width - 20, m_height - 20);
+    creature->setId(++m_nextCreatureId);
+    creature->restartAnimation(m_tick);
     m_creatures.push_back(creature);
+    ++m_version;
 }
 
 void Aquarium::addAquariumLevel(std::shared_ptr<AquariumLevel> level){
@@ -375,29 +335,194 @@ void Aquarium::addAquariumLevel(std::shared_ptr<AquariumLevel> level){
     this->m_aquariumlevels.push_back(level);
 }
 
-void Aquarium::update() {
+void Aquarium::setLevelTable(const LevelTable& table){
+    if(table.empty()){return;} // an aquarium without levels can't repopulate
+
+    std::vector<std::shared_ptr<AquariumLevel>> previous;
+    previous.swap(this->m_aquariumlevels);
+    this->m_levelTable = table;
+
+    for(size_t i = 0; i < table.levels.size(); ++i){
+        const LevelDef& def = table.levels[i];
+        auto level = std::make_shared<AquariumLevel>(int(i), def.targetScore);
+        for(int s = def.spawnBegin; s < def.spawnBegin + def.spawnCount; ++s){
+            level->AddPopulation(table.spawns[s].type, table.spawns[s].count);
+        }
+        if(i < previous.size()){
+            level->CopyProgressFrom(*previous[i]);
+        }
+        this->addAquariumLevel(level);
+    }
+}
+
+void Aquarium::update(const WorldContext& world) {
+    PROFILE_SCOPE("aquarium");
+    this->gatherSchooling(world);
+    this->solveSchooling();
+    this->steerSchooling();
+    this->moveCreatures(world, MoveGroup::Predators);
+    this->moveCreatures(world, MoveGroup::Others);
+    this->solveChains();
+    this->finishUpdate();
+}
+
+// Base fish school together and flee from the player and predators. The
+// heavy part runs on flat arrays inside SchoolingSystem, here we only gather
+// positions and hand the resulting headings back to the creatures.
+void Aquarium::gatherSchooling(const WorldContext& world) {
+    PROFILE_SCOPE("schooling");
+    m_schooling.Clear();
+    m_schoolingFish.clear();
+    m_predators.clear();
+    m_movers.clear();
+    m_tick = world.tick;
+
     for (auto& creature : m_creatures) {
-        creature->move();
+        NPCreature* npc = dynamic_cast<NPCreature*>(creature.get());
+        if (npc && IsPredatorType(npc->GetType())) {
+            m_schooling.AddThreat(npc->getX(), npc->getY());
+            m_predators.push_back(npc);
+            continue;
+        }
+        if (npc && npc->GetType() == AquariumCreatureType::NPCreature) {
+            m_schooling.AddFish(npc->getX(), npc->getY(), npc->getDx(), npc->getDy());
+            m_schoolingFish.push_back(npc);
+        }
+        m_movers.push_back(creature.get());
     }
 
-    // Power-up spawn logic, once every 10s at most, with a small chance each second
+    if (world.player.present && !m_schoolingFish.empty()) {
+        m_schooling.AddThreat(world.player.x, world.player.y);
+    }
+}
+
+void Aquarium::solveSchooling() {
+    PROFILE_SCOPE("schooling");
+    if (m_schoolingFish.empty()) { return; }
+    // a normal level has ~30 fish, only big schools are worth the threads
+    WorkerPool* pool = m_schoolingFish.size() >= 512 ? &WorkerPool::Shared() : nullptr;
+    m_schooling.Solve(m_width, m_height, pool);
+}
+
+void Aquarium::steerSchooling() {
+    for (size_t i = 0; i < m_schoolingFish.size(); ++i) {
+        m_schoolingFish[i]->steer(m_schooling.GetHeadingX(i), m_schooling.GetHeadingY(i));
+    }
+}
+
+void Aquarium::moveCreatures(const WorldContext& world, MoveGroup group) {
+    PROFILE_SCOPE("move");
+    const int interval = m_farUpdateInterval;
+    const float farSq = m_farDistance * m_farDistance;
+    const std::vector<Creature*>& creatures = group == MoveGroup::Predators ? m_predators : m_movers;
+    for (Creature* creature : creatures) {
+        if (interval > 1 && world.player.present) {
+            float dx = creature->getX() - world.player.x;
+            float dy = creature->getY() - world.player.y;
+            if (dx * dx + dy * dy > farSq) {
+                // far away creatures take turns, each catching up a whole
+                // interval at once; the id spreads them over the ticks
+                if ((world.tick + creature->getId()) % interval == 0) {
+                    creature->moveSteps(world, interval);
+                }
+                continue;
+            }
+        }
+        creature->move(world);
+    }
+}
+
+void Aquarium::solveChains() {
+    // heads moved above, now every predator body follows in one batch
+    PROFILE_SCOPE("chains");
+    m_chainPool->Solve();
+}
+
+void Aquarium::finishUpdate() {
+    // Power-up spawn logic, the chance and cooldown come from the current level
+    const LevelDef& levelDef = m_levelTable.levels[this->selectedLevelIndex()];
     if (m_powerupCooldownFrames > 0) {
         --m_powerupCooldownFrames;
     } else {
-        // 1% chance per frame at 60fps would be too frequent; do smaller.
-        // Try 0.2% per frame (once every 8s on average) but only when cooldown is 0.
-        if (ofRandom(0.0f, 1.0f) < 0.002f) {
+        if (GameRandom::Range(m_rng, 0.0f, 1.0f) < levelDef.powerUpChance) {
             this->SpawnCreature(AquariumCreatureType::SpeedPowerUp);
-            m_powerupCooldownFrames = 10 * 60; // 10 seconds cooldown
+            m_powerupCooldownFrames = levelDef.powerUpCooldownFrames;
         }
     }
 
     this->Repopulate();
+    ++m_version;
+}
+
+void Aquarium::setPredatorLod(int step) {
+    m_predatorLodStep = std::max(step, 1);
+    for (auto& creature : m_creatures) {
+        if (auto predator = dynamic_cast<Predator*>(creature.get())) { predator->setDrawStep(m_predatorLodStep); }
+    }
+    // pooled ones too, snapshot loads bring them back
+    for (AquariumCreatureType type : {AquariumCreatureType::BabyPredator, AquariumCreatureType::Predator}) {
+        for (auto& creature : m_creaturePool[size_t(type)]) {
+            static_cast<Predator*>(creature.get())->setDrawStep(m_predatorLodStep);
+        }
+    }
 }
 
-void Aquarium::draw() const {
+void Aquarium::buildDrawList() {
+    PROFILE_SCOPE("draw list");
+    m_drawList.clear();
     for (const auto& creature : m_creatures) {
-        creature->draw();
+        AquariumDrawItem item;
+        const NPCreature* npc = dynamic_cast<const NPCreature*>(creature.get());
+        CreatureKind kind = npc ? GetArchetype(npc->GetType()).kind : CreatureKind::PowerUp;
+        if (kind == CreatureKind::Swimmer || kind == CreatureKind::Walker) {
+            item.x = creature->getX();
+            item.y = creature->getY();
+            item.sprite = creature->getSprite();
+            item.animation = creature->getAnimation();
+            item.animationStart = creature->getAnimationStart();
+            item.flipped = creature->isFlipped();
+        } else {
+            item.custom = creature.get();
+        }
+        m_drawList.push_back(item);
+    }
+    m_drawListVersion = m_version;
+}
+
+void Aquarium::draw(AnimationBatch* batch) const {
+    // anything drawn straight away first flushes the animated creatures
+    // listed before it, so the layering is still the creature order. Only
+    // within a run of animated ones does the batch go sheet by sheet.
+    auto flush = [batch] {
+        if (batch && batch->HasPending()) {
+            batch->Flush();
+            ofSetColor(ofColor::white);
+        }
+    };
+    if (m_drawListVersion != m_version) {
+        for (const auto& creature : m_creatures) {
+            if (batch && creature->getAnimation()) {
+                batch->Add(creature->getAnimation(), creature->getAnimationStart(), creature->getX(), creature->getY(), creature->isFlipped());
+            } else {
+                flush();
+                creature->draw();
+            }
+        }
+        return;
+    }
+    ofSetColor(ofColor::white);
+    for (const AquariumDrawItem& item : m_drawList) {
+        if (batch && item.animation) {
+            batch->Add(item.animation, item.animationStart, item.x, item.y, item.flipped);
+            continue;
+        }
+        flush();
+        if (item.custom) {
+            item.custom->draw();
+            ofSetColor(ofColor::white);
+        } else if (const GameSprite* sprite = SpriteTable::Get(item.sprite)) {
+            sprite->draw(item.x, item.y, item.flipped);
+        }
     }
 }
 
@@ -409,16 +534,55 @@ void Aquarium::removeCreature(std::shared_ptr<Creature> creature) {
 
         // Only consume population if this is an NPC-style creature that contributes to levels
         if (auto npc = std::dynamic_pointer_cast<NPCreature>(creature)) {
-            int selectLvl = this->currentLevel % this->m_aquariumlevels.size();
-            this->m_aquariumlevels.at(selectLvl)->ConsumePopulation(npc->GetType(), npc->getValue());
+            this->m_aquariumlevels.at(this->selectedLevelIndex())->ConsumePopulation(npc->GetType(), npc->getValue());
         }
 
         m_creatures.erase(it);
+        ++m_version;
+    }
+}
+
+void Aquarium::removeCreature(CreatureHandle handle) {
+    Creature* target = this->resolve(handle);
+    for (const auto& creature : m_creatures) {
+        if (creature.get() == target) {
+            this->removeCreature(creature); // takes a copy, safe to erase
+            return;
+        }
     }
 }
 
+CreatureHandle Aquarium::getHandleAt(int index) const {
+    if (index < 0 || size_t(index) >= m_creatures.size()) { return CreatureHandle(); }
+    return CreatureHandle{m_creatures[index]->getId(), uint32_t(index)};
+}
+
+Creature* Aquarium::resolve(CreatureHandle handle) const {
+    if (!handle.isValid()) { return nullptr; }
+    if (handle.slot < m_creatures.size() && m_creatures[handle.slot]->getId() == handle.id) {
+        return m_creatures[handle.slot].get();
+    }
+    // creatures before it were removed since, look it up
+    for (const auto& creature : m_creatures) {
+        if (creature->getId() == handle.id) { return creature.get(); }
+    }
+    return nullptr;
+}
+
+void Aquarium::Reset() {
+    this->clearCreatures();
+    this->m_spawnScheduler.Clear();
+    for (auto& level : this->m_aquariumlevels) {
+        level->levelReset();
+    }
+    this->currentLevel = 0;
+    this->m_powerupCooldownFrames = 0;
+    this->Repopulate();
+}
+
 void Aquarium::clearCreatures() {
     m_creatures.clear();
+    ++m_version;
 }
 
 std::shared_ptr<Creature> Aquarium::getCreatureAt(int index) {
@@ -431,45 +595,82 @@ std::shared_ptr<Creature> Aquarium::getCreatureAt(int index) {
 
 
 void Aquarium::SpawnCreature(AquariumCreatureType type) {
-    int x = rand() % this->getWidth();
-    int y = rand() % this->getHeight();
-    int speed = 1 + rand() % 25; // Speed between 1 and 25
-    int predatorSpeed = 10;
-    int babyPredatorSpeed = 9 + rand() % 3; // Speed between 9 and 12
-
-    switch (type) {
-        case AquariumCreatureType::NPCreature:
-            this->addCreature(std::make_shared<NPCreature>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::NPCreature)));
-            break;
-        case AquariumCreatureType::BiggerFish:
-            this->addCreature(std::make_shared<BiggerFish>(x, y, speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::BiggerFish)));
-            break;
-        case AquariumCreatureType::Crab:
-            this->addCreature(std::make_shared<Crab>(x, this->getHeight(), speed, this->m_sprite_manager->GetSprite(AquariumCreatureType::Crab)));
-            break;
-        case AquariumCreatureType::Predator:
-            this->addCreature(std::make_shared<Predator>(x, 0, predatorSpeed, this->m_sprite_manager->GetSprite(AquariumCreatureType::Predator),
-                                                        this->m_sprite_manager->GetSprite(AquariumCreatureType::PredatorBody),
-                                                        this->m_sprite_manager->GetSprite(AquariumCreatureType::PredatorTail), 10));
-            break;
-        case AquariumCreatureType::BabyPredator:
-            this->addCreature(std::make_shared<Predator>(x, 0, babyPredatorSpeed, this->m_sprite_manager->GetSprite(AquariumCreatureType::Predator),
-                                                        this->m_sprite_manager->GetSprite(AquariumCreatureType::PredatorBody),
-                                                        this->m_sprite_manager->GetSprite(AquariumCreatureType::PredatorTail), 4));
-            break;
-        case AquariumCreatureType::SpeedPowerUp: {
-            int x = rand() % this->getWidth();
-            int y = rand() % this->getHeight();
-            auto pu = std::make_shared<SpeedPowerUp>(x, y);
-            pu->setBounds(this->getWidth(), this->getHeight());
-            this->addCreature(pu);
-            break;
-        }                                             
-        default:
-            ofLogError() << "Unknown creature type to spawn!";
-            break;
+    Trace::Instant("spawn", int64_t(type));
+    int x = GameRandom::Below(m_rng, this->getWidth());
+    int y = GameRandom::Below(m_rng, this->getHeight());
+    // speed range comes from the level table, anything not listed uses its archetype's
+    int minSpeed = GetArchetype(type).minSpeed;
+    int maxSpeed = GetArchetype(type).maxSpeed;
+    if (const LevelSpawnDef* spawn = m_levelTable.FindSpawn(this->selectedLevelIndex(), type)) {
+        minSpeed = spawn->minSpeed;
+        maxSpeed = spawn->maxSpeed;
     }
+    int speed = minSpeed + GameRandom::Below(m_rng, maxSpeed - minSpeed + 1);
 
+    std::shared_ptr<Creature> creature = this->createCreature(type, x, y, speed);
+    if (creature) {
+        this->addCreature(creature);
+    }
+}
+
+SpriteId Aquarium::spriteFor(AquariumCreatureType type) const {
+    // headless aquariums have no sprite manager, their creatures go without sprites
+    return this->m_sprite_manager ? this->m_sprite_manager->GetSprite(type) : 0;
+}
+
+template <AquariumCreatureType T>
+std::shared_ptr<Creature> Aquarium::createArchetype(int x, int y, int speed) {
+    constexpr CreatureKind kind = GetArchetype(T).kind;
+    if constexpr (kind == CreatureKind::Swimmer || kind == CreatureKind::Walker) {
+        auto creature = std::make_shared<ArchetypeCreature<T>>(x, y, this->getHeight(), speed, this->spriteFor(T), m_rng);
+        if (this->m_sprite_manager) { creature->setAnimation(this->m_sprite_manager->GetAnimation(T)); }
+        return creature;
+    } else if constexpr (kind == CreatureKind::Predator) {
+        auto predator = std::make_shared<Predator>(T, x, 0, speed, this->spriteFor(T),
+                                                   this->spriteFor(AquariumCreatureType::PredatorBody),
+                                                   this->spriteFor(AquariumCreatureType::PredatorTail), m_chainPool, m_rng);
+        predator->setDrawStep(m_predatorLodStep);
+        return predator;
+    } else if constexpr (kind == CreatureKind::PowerUp) {
+        return std::make_shared<SpeedPowerUp>(x, y);
+    } else {
+        ofLogError() << GetArchetype(T).name << " is part of a predator and can't be spawned on its own";
+        return nullptr;
+    }
+}
+
+std::shared_ptr<Creature> Aquarium::createCreature(AquariumCreatureType type, int x, int y, int speed) {
+    static constexpr auto factories = archetypeFactories(std::make_index_sequence<CreatureArchetypeCount>());
+    if (size_t(type) >= factories.size()) {
+        ofLogError() << "Unknown creature type to spawn!";
+        return nullptr;
+    }
+    return (this->*factories[size_t(type)])(x, y, speed);
+}
+
+std::shared_ptr<Creature> Aquarium::acquirePooledCreature(AquariumCreatureType type) {
+    std::vector<std::shared_ptr<Creature>>& pool = m_creaturePool[int(type)];
+    if (pool.empty()) {
+        return this->createCreature(type, 0, 0, 0);
+    }
+    std::shared_ptr<Creature> creature = std::move(pool.back());
+    pool.pop_back();
+    return creature;
+}
+
+void Aquarium::recycleAllCreatures() {
+    for (std::shared_ptr<Creature>& creature : m_creatures) {
+        AquariumCreatureType type = AquariumCreatureType::SpeedPowerUp;
+        if (auto npc = dynamic_cast<NPCreature*>(creature.get())) {
+            type = npc->GetType();
+        }
+        if (auto predator = dynamic_cast<Predator*>(creature.get())) {
+            predator->releaseSegments(); // a parked body must not be solved
+        }
+        m_creaturePool[int(type)].push_back(std::move(creature));
+    }
+    m_creatures.clear();
+    ++m_version;
 }
 
 
@@ -478,9 +679,10 @@ void Aquarium::SpawnCreature(AquariumCreatureType type) {
 // once lvl criteria met, we move to new lvl through inner signal asking for new lvl
 // which will mean incrementing the buffer and pointing to a new lvl index
 void Aquarium::Repopulate() {
+    PROFILE_SCOPE("repopulate");
     ofLogVerbose("entering phase repopulation");
     // lets make the levels circular
-    int selectedLevelIdx = this->currentLevel % this->m_aquariumlevels.size();
+    int selectedLevelIdx = this->selectedLevelIndex();
     ofLogVerbose() << "the current index: " << selectedLevelIdx << endl;
     std::shared_ptr<AquariumLevel> level = this->m_aquariumlevels.at(selectedLevelIdx);
 
@@ -488,161 +690,326 @@ void Aquarium::Repopulate() {
     if(level->isCompleted()){
         level->levelReset();
         this->currentLevel += 1;
-        selectedLevelIdx = this->currentLevel % this->m_aquariumlevels.size();
+        selectedLevelIdx = this->selectedLevelIndex();
         ofLogNotice()<<"new level reached : " << selectedLevelIdx << std::endl;
+        Trace::Instant("new level", selectedLevelIdx);
+        if(this->m_eventBus){
+            GameEvent event(GameEventType::NEW_LEVEL);
+            event.value = selectedLevelIdx;
+            this->m_eventBus->Publish(event);
+        }
         level = this->m_aquariumlevels.at(selectedLevelIdx);
         this->clearCreatures();
+        this->m_spawnScheduler.Clear(); // whatever the old level still had queued is gone
     }
 
-    
-    // now lets find how many to respawn if needed 
-    std::vector<AquariumCreatureType> toRespawn = level->Repopulate();
-    ofLogVerbose() << "amount to repopulate : " << toRespawn.size() << endl;
-    if(toRespawn.size() <= 0 ){return;} // there is nothing for me to do here
-    for(AquariumCreatureType newCreatureType : toRespawn){
-        this->SpawnCreature(newCreatureType);
+    // queue up what is missing, the level skips this when nothing changed
+    if(level->IsDirty()){
+        level->Repopulate(this->m_toRespawn);
+        ofLogVerbose() << "amount to repopulate : " << m_toRespawn.size() << endl;
+        for(AquariumCreatureType newCreatureType : this->m_toRespawn){
+            this->m_spawnScheduler.Enqueue(newCreatureType);
+        }
+        this->m_toRespawn.clear();
     }
+
+    // and spawn only as much as this tick's budget allows
+    this->m_spawnScheduler.Drain([this](AquariumCreatureType type){ this->SpawnCreature(type); });
 }
 
 
 // Aquarium collision detection
-std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player) {
-    if (!aquarium || !player) return nullptr;
-    
-    for (int i = 0; i < aquarium->getCreatureCount(); ++i) {
-        std::shared_ptr<Creature> npc = aquarium->getCreatureAt(i);
+GameEvent DetectAquariumCollisions(Aquarium& aquarium, PlayerCreature& player) {
+    const float px = player.getX();
+    const float py = player.getY();
+    const CreatureHandle playerHandle; // the player is not an aquarium creature
+
+    for (int i = 0; i < aquarium.getCreatureCount(); ++i) {
+        Creature* npc = aquarium.getCreatures()[i].get();
 
         // Power-up collision (handle early and continue)
         // Collision detection is so weird... -Diego
-        if (auto pu = std::dynamic_pointer_cast<SpeedPowerUp>(npc)) {
-            float dx = pu->getX() - player->getX();
-            float dy = pu->getY() - player->getY();
+        if (auto pu = dynamic_cast<SpeedPowerUp*>(npc)) {
+            float dx = pu->getX() - px;
+            float dy = pu->getY() - py;
             float distSq = dx*dx + dy*dy;
-            float rr = (pu->getCollisionRadius() + player->getCollisionRadius());
+            float rr = (pu->getCollisionRadius() + player.getCollisionRadius());
             if (distSq < rr * rr) {
                 // Apply 2x speed for 5 seconds
-                player->applySpeedBoost(/*factor*/ 2.0f, /*durationFrames*/ 5 * 60);
-                aquarium->removeCreature(pu);
-                return std::make_shared<GameEvent>(GameEventType::POWER_UP, player, nullptr);
+                player.applySpeedBoost(/*factor*/ 2.0f, /*durationFrames*/ 5 * 60);
+                GameEvent event(GameEventType::POWER_UP, playerHandle, aquarium.getHandleAt(i));
+                event.x = pu->getX();
+                event.y = pu->getY();
+                aquarium.removeCreature(event.creatureB);
+                return event;
             }
             continue; // Done evaluating this entry
         }
 
-        if (auto predator = std::dynamic_pointer_cast<Predator>(npc)) {
-            std::vector<Predator::Segment> segments = predator->getSegments();
-            for (size_t s = 0; s < segments.size(); ++s) {
-                float dx = segments[s].position.x - player->getX();
-                float dy = segments[s].position.y - player->getY();
+        bool hit = false;
+        if (auto predator = dynamic_cast<Predator*>(npc)) {
+            // most chains are nowhere near the player, one box test rules
+            // the whole body out
+            PredatorCullStats& cull = aquarium.getPredatorCullStats();
+            if (!predator->getBounds().near(px, py, Predator::MaxHitRadius)) {
+                ++cull.culled;
+                continue;
+            }
+            ++cull.tested;
+            ChainView segments = predator->getSegments();
+            for (size_t s = 0; s < segments.size() && !hit; ++s) {
+                float dx = segments.x(s) - px;
+                float dy = segments.y(s) - py;
                 float distanceSq = dx * dx + dy * dy;
-                float collisionRadius = (s == 0) ? 35.0f : (s == segments.size() - 1) ? 15.0f : 12.0f;
-                if (distanceSq < collisionRadius * collisionRadius) {
-                    return std::make_shared<GameEvent>(GameEventType::COLLISION, player, predator);
-                }
+                float collisionRadius = (s == 0) ? Predator::HeadHitRadius : (s == segments.size() - 1) ? Predator::TailHitRadius : Predator::BodyHitRadius;
+                hit = distanceSq < collisionRadius * collisionRadius;
             }
+            cull.hits += hit;
         }
         else {
-            if (npc && checkCollision(player, npc)) {
-                return std::make_shared<GameEvent>(GameEventType::COLLISION, player, npc);
-            }
+            hit = npc && checkCollision(player, *npc);
+        }
+
+        if (hit) {
+            GameEvent event(GameEventType::COLLISION, playerHandle, aquarium.getHandleAt(i));
+            event.x = npc->getX();
+            event.y = npc->getY();
+            event.value = npc->getValue();
+            return event;
         }
     }
-    return nullptr;
+    return GameEvent();
 };
 
 //  Imlementation of the AquariumScene
 
+void AquariumGameScene::SetQuality(const QualitySettings& quality){
+    this->m_aquarium->setPredatorLod(quality.predatorLodStep);
+    this->m_aquarium->setFarUpdateInterval(quality.farUpdateInterval);
+    this->m_particles.SetBudget(quality.particleBudget);
+}
+
+void AquariumGameScene::Restart(){
+    PlayerProgress fresh;
+    fresh.baseSpeed = this->m_player->getProgress().baseSpeed;
+    this->m_player->setProgress(fresh);
+    this->m_player->setState(CreatureState{WorldWidth / 2.0f - 50, WorldHeight / 2.0f - 50, 0, 0, fresh.baseSpeed});
+    this->m_player->setSprinting(false);
+    this->m_aquarium->Reset();
+    this->m_particles.Clear();
+    this->m_gameOver = false;
+}
+
 void AquariumGameScene::Update(){
-    std::shared_ptr<GameEvent> event;
-
-    float dx = 0;
-    float dy = 0;
-
-    if(keysDown[OF_KEY_LEFT])  dx -= 1;
-    if(keysDown[OF_KEY_RIGHT]) dx += 1;
-    if(keysDown[OF_KEY_UP])    dy -= 1;
-    if(keysDown[OF_KEY_DOWN])  dy += 1;
-
-    m_player->setDirection(dx, dy);
-    this->m_player->update();
-
-    if (this->updateControl.tick()) {
-        event = DetectAquariumCollisions(this->m_aquarium, this->m_player);
-        if (event != nullptr && event->isCollisionEvent()) {
-            ofLogVerbose() << "Collision detected between player and NPC!" << std::endl;
-            if(event->creatureB != nullptr){
-                event->print();
-                if(this->m_player->getPower() < event->creatureB->getValue()){
-                    ofLogNotice() << "Player is too weak to eat the creature!" << std::endl;
-                    this->m_player->loseLife(3*60); // 3 frames debounce, 3 seconds at 60fps
-                    if(this->m_player->getLives() <= 0){
-                        this->m_lastEvent = std::make_shared<GameEvent>(GameEventType::GAME_OVER, this->m_player, nullptr);
-                        return;
-                    }
-                }
-                else{
-                    this->m_aquarium->removeCreature(event->creatureB);
-                    this->m_player->addToScore(1, event->creatureB->getValue());
-                    if (this->m_player->getScore() % 25 == 0){
-                        this->m_player->increasePower(1);
-                        if (this->m_player->getPower() == 5) {
-                            this->m_player->setSprite(m_aquarium->getSpriteManager()->GetPlayerSprite(PlayerType::Shark));
-                            
-                        }
-                        else if (this->m_player->getPower() == 10) {
-                            this->m_player->setSprite(m_aquarium->getSpriteManager()->GetPlayerSprite(PlayerType::Whale));
-                        }
-                        ofLogNotice() << "Player power increased to " << this->m_player->getPower() << "!" << std::endl;
-                    }
+    if (this->m_frameGraph.GetTaskCount() == 0) {
+        this->buildFrameGraph();
+    }
+    // without a scheduler the graph runs its tasks in the order they were
+    // added, which is exactly Simulate() plus the windowed extras
+    this->m_frameGraph.Run(this->m_scheduler);
+}
+
+// Edges are the data each stage reads. Predators never look at the fish,
+// and the particles only at the player and their own events.
+void AquariumGameScene::buildFrameGraph(){
+    Aquarium& aquarium = *this->m_aquarium;
+    TaskGraph& graph = this->m_frameGraph;
+    graph.Clear();
+    auto player = graph.Add("player", [this] { this->beginTick(); });
+    auto collide = graph.Add("collide", [this] { if (this->m_aquariumTick) { this->collide(); } }, {player});
+    auto events = graph.Add("events", [this] { if (this->m_aquariumTick) { this->handleEvent(); } }, {collide});
+    auto gather = graph.Add("gather", [this, &aquarium] {
+        if (this->m_aquariumTick) { aquarium.gatherSchooling(this->m_world); }
+    }, {events});
+    auto school = graph.Add("schooling", [this, &aquarium] { if (this->m_aquariumTick) { aquarium.solveSchooling(); } }, {gather});
+    auto steer = graph.Add("steer", [this, &aquarium] { if (this->m_aquariumTick) { aquarium.steerSchooling(); } }, {school});
+    auto predators = graph.Add("predators", [this, &aquarium] {
+        if (this->m_aquariumTick) { aquarium.moveCreatures(this->m_world, MoveGroup::Predators); }
+    }, {gather});
+    auto fish = graph.Add("move", [this, &aquarium] {
+        if (this->m_aquariumTick) { aquarium.moveCreatures(this->m_world, MoveGroup::Others); }
+    }, {steer});
+    auto chains = graph.Add("chains", [this, &aquarium] { if (this->m_aquariumTick) { aquarium.solveChains(); } }, {predators});
+    auto finish = graph.Add("repopulate", [this, &aquarium] { if (this->m_aquariumTick) { aquarium.finishUpdate(); } }, {fish, chains});
+    graph.Add("draw list", [this, &aquarium] { if (this->m_aquariumTick) { aquarium.buildDrawList(); } }, {finish});
+    graph.Add("particles", [this] { this->updateParticles(); }, {events});
+}
+
+void AquariumGameScene::updateParticles(){
+    // effects run on real frame time, they are not part of the simulation
+    PROFILE_SCOPE("particles");
+    float dt = std::min(float(ofGetLastFrameTime()), 0.1f);
+    if (this->m_player->getSpeedBoostFramesLeft() > 0) {
+        this->m_particles.Emit(ParticleEffect::Trail, this->m_player->getX(), this->m_player->getY());
+    }
+    this->m_particles.EmitAmbient(dt, this->m_aquarium->getWidth(), this->m_aquarium->getHeight());
+    this->m_particles.Update(dt);
+}
+
+void AquariumGameScene::Simulate(){
+    PROFILE_SCOPE("simulate");
+    this->beginTick();
+    if (!this->m_aquariumTick) { return; }
+    this->collide();
+    this->handleEvent();
+    if (!this->m_aquariumTick) { return; }
+    this->m_aquarium->update(this->m_world);
+}
+
+void AquariumGameScene::beginTick(){
+    this->m_aquariumTick = false;
+    if (this->m_gameOver) { return; }
+    if (this->m_controller) {
+        this->m_controller->Drive(*this->m_player, *this->m_aquarium);
+    }
+
+    // one context per tick; the player snapshot is refreshed after the
+    // player moves so the NPCs react to where it is now
+    WorldContext& world = this->m_world;
+    world.tick = ++this->m_tick;
+    world.time = this->m_tick / 60.0f;
+    world.width = float(this->m_aquarium->getWidth());
+    world.height = float(this->m_aquarium->getHeight());
+    this->m_player->update(world);
+    world.player = this->m_player->snapshot();
+
+    this->m_aquariumTick = this->updateControl.tick();
+}
+
+void AquariumGameScene::collide(){
+    PROFILE_SCOPE("collisions");
+    this->m_event = DetectAquariumCollisions(*this->m_aquarium, *this->m_player);
+}
+
+void AquariumGameScene::handleEvent(){
+    GameEvent& event = this->m_event;
+    if (event.type == GameEventType::POWER_UP) {
+        Trace::Instant("power up");
+        this->publish(event);
+    }
+    if (event.isCollisionEvent()) {
+        Trace::Instant("collision", event.value);
+        ofLogVerbose() << "Collision detected between player and NPC!" << std::endl;
+        event.print();
+        if(this->m_player->getPower() < event.value){
+            ofLogNotice() << "Player is too weak to eat the creature!" << std::endl;
+            int livesBefore = this->m_player->getLives();
+            this->m_player->loseLife(3*60); // 3 frames debounce, 3 seconds at 60fps
+            if(this->m_player->getLives() < livesBefore){
+                GameEvent hurt(GameEventType::PLAYER_HURT, event.creatureA, event.creatureB);
+                hurt.x = this->m_player->getX();
+                hurt.y = this->m_player->getY();
+                hurt.value = this->m_player->getLives();
+                this->publish(hurt);
+            }
+            if(this->m_player->getLives() <= 0){
+                this->m_gameOver = true;
+                this->m_aquariumTick = false; // the rest of the tick is skipped
+                this->publish(GameEvent(GameEventType::GAME_OVER));
+                return;
+            }
+        }
+        else{
+            GameEvent eaten(GameEventType::CREATURE_REMOVED, event.creatureB);
+            eaten.x = event.x;
+            eaten.y = event.y;
+            eaten.value = event.value;
+            this->m_aquarium->removeCreature(event.creatureB);
+            this->publish(eaten);
+            this->m_player->addToScore(1, event.value);
+            if (this->m_player->getScore() % 25 == 0){
+                this->m_player->increasePower(1);
+                auto sprites = m_aquarium->getSpriteManager(); // null when running headless
+                if (sprites && this->m_player->getPower() == 5) {
+                    this->m_player->setSprite(sprites->GetPlayerSprite(PlayerType::Shark));
                     
                 }
-                
-                
-
-            } else {
-                ofLogError() << "Error: creatureB is null in collision event." << std::endl;
+                else if (sprites && this->m_player->getPower() == 10) {
+                    this->m_player->setSprite(sprites->GetPlayerSprite(PlayerType::Whale));
+                }
+                ofLogNotice() << "Player power increased to " << this->m_player->getPower() << "!" << std::endl;
             }
+            
         }
-        this->m_aquarium->update();
     }
-
 }
 
 void AquariumGameScene::Draw() {
     this->m_player->draw();
-    this->m_aquarium->draw();
+    {
+        PROFILE_SCOPE("draw creatures");
+        // animated fish are only collected here, the batch draws them all at once
+        this->m_animations.Begin(this->m_tick);
+        this->m_aquarium->draw(&this->m_animations);
+        ofSetColor(ofColor::white);
+        this->m_animations.End();
+    }
+    {
+        PROFILE_SCOPE("draw particles");
+        this->m_particles.Draw();
+    }
     this->paintAquariumHUD();
 
 }
 
 
 void AquariumGameScene::paintAquariumHUD(){
-    float panelWidth = ofGetWindowWidth() - 150;
-    ofDrawBitmapString("Score: " + std::to_string(this->m_player->getScore()), panelWidth, 20);
-    ofDrawBitmapString("Power: " + std::to_string(this->m_player->getPower()), panelWidth, 30);
-    ofDrawBitmapString("Lives: " + std::to_string(this->m_player->getLives()), panelWidth, 40);
-    for (int i = 0; i < this->m_player->getLives(); ++i) {
-        ofSetColor(ofColor::red);
-        ofDrawCircle(panelWidth + i * 20, 50, 5);
+    PROFILE_SCOPE("hud");
+    HudFields fields;
+    fields.score = this->m_player->getScore();
+    fields.power = this->m_player->getPower();
+    fields.lives = this->m_player->getLives();
+    fields.level = this->m_aquarium->getCurrentLevel();
+    fields.boostSeconds = (this->m_player->getSpeedBoostFramesLeft() + 59) / 60;
+    this->m_hud.Draw(this->m_aquarium->getWidth() - 150, 0, fields);
+}
+
+void AquariumLevel::AddPopulation(AquariumCreatureType creatureType, int population){
+    this->m_levelPopulation.emplace_back(creatureType, population);
+    this->m_dirty = true;
+}
+
+void AquariumLevel::CopyProgressFrom(const AquariumLevel& other){
+    this->m_level_score = other.m_level_score;
+    for(AquariumLevelPopulationNode& node : this->m_levelPopulation){
+        for(const AquariumLevelPopulationNode& old : other.m_levelPopulation){
+            if(old.creatureType == node.creatureType){
+                // creatures already swimming stay, a lower count just stops respawns
+                node.currentPopulation = old.currentPopulation;
+                break;
+            }
+        }
+    }
+    this->m_dirty = true;
+}
+
+void AquariumLevel::RestorePopulation(AquariumCreatureType creatureType, int currentPopulation){
+    for(AquariumLevelPopulationNode& node : this->m_levelPopulation){
+        if(node.creatureType == creatureType){
+            node.currentPopulation = std::min(currentPopulation, node.population);
+        }
     }
-    ofSetColor(ofColor::white); // Reset color to white for other drawings
+    this->m_dirty = true;
 }
 
 void AquariumLevel::populationReset(){
-    for(auto node: this->m_levelPopulation){
-        node->currentPopulation = 0; // need to reset the population to ensure they are made a new in the next level
+    for(auto& node: this->m_levelPopulation){
+        node.currentPopulation = 0; // need to reset the population to ensure they are made a new in the next level
     }
+    this->m_dirty = true;
 }
 
 void AquariumLevel::ConsumePopulation(AquariumCreatureType creatureType, int power){
-    for(std::shared_ptr<AquariumLevelPopulationNode> node: this->m_levelPopulation){
+    for(AquariumLevelPopulationNode& node: this->m_levelPopulation){
         ofLogVerbose() << "consuming from this level creatures" << endl;
-        if(node->creatureType == creatureType){
-            ofLogVerbose() << "-cosuming from type: " << AquariumCreatureTypeToString(node->creatureType) <<" , currPop: " << node->currentPopulation << endl;
-            if(node->currentPopulation == 0){
+        if(node.creatureType == creatureType){
+            ofLogVerbose() << "-cosuming from type: " << AquariumCreatureTypeToString(node.creatureType) <<" , currPop: " << node.currentPopulation << endl;
+            if(node.currentPopulation == 0){
                 return;
             } 
-            node->currentPopulation -= 1;
-            ofLogVerbose() << "+cosuming from type: " << AquariumCreatureTypeToString(node->creatureType) <<" , currPop: " << node->currentPopulation << endl;
+            node.currentPopulation -= 1;
+            this->m_dirty = true;
+            ofLogVerbose() << "+cosuming from type: " << AquariumCreatureTypeToString(node.creatureType) <<" , currPop: " << node.currentPopulation << endl;
             this->m_level_score += power;
             return;
         }
@@ -657,15 +1024,15 @@ bool AquariumLevel::isCompleted(){
 // Completely got rid of every single inherited Repopulate function,
 // will only inherit from AquariumLevel to be more straightforward.
 
-std::vector<AquariumCreatureType> AquariumLevel::Repopulate() {
-    std::vector<AquariumCreatureType> toRepopulate;
-    for (const auto& node : m_levelPopulation) {
-        int delta = node->population - node->currentPopulation;
+void AquariumLevel::Repopulate(std::vector<AquariumCreatureType>& out) {
+    if (!m_dirty) { return; }
+    for (auto& node : m_levelPopulation) {
+        int delta = node.population - node.currentPopulation;
         if (delta > 0) {
             // Push "delta" copies of creature type
-            toRepopulate.insert(toRepopulate.end(), delta, node->creatureType);
-            node->currentPopulation += delta;
+            out.insert(out.end(), delta, node.creatureType);
+            node.currentPopulation += delta;
         }
     }
-    return toRepopulate;
+    m_dirty = false;
 }
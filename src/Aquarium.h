@@ -1,31 +1,30 @@
+#pragma once
 #define NOMINMAX // To avoid min/max macro conflict on Windows
 
+#include <array>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <iostream>
 #include <algorithm>
 #include "Core.h"
+#include "PredatorChain.h"
+#include "Schooling.h"
+#include "CreatureTypes.h"
+#include "CreatureArchetypes.h"
+#include "LevelTable.h"
+#include "SpawnScheduler.h"
+#include "GameEventBus.h"
+#include "AquariumHud.h"
+#include "ParticleSystem.h"
+#include "FramePacer.h"
+#include "InputState.h"
+#include "PlayerController.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "TaskGraph.h"
 
 
-enum class AquariumCreatureType {
-    NPCreature,
-    BiggerFish,
-    BabyPredator,
-    Predator,
-    PredatorBody,
-    PredatorTail,
-    Crab,
-    SpeedPowerUp
-};
-
-enum class PlayerType {
-    Pirahna,
-    Shark,
-    Whale
-};
-
-string AquariumCreatureTypeToString(AquariumCreatureType t);
-
 class AquariumLevelPopulationNode{
     public:
         AquariumLevelPopulationNode() = default;
@@ -43,43 +42,72 @@ class AquariumLevel : public GameLevel {
     public:
         AquariumLevel(int levelNumber, int targetScore)
         : GameLevel(levelNumber), m_level_score(0), m_targetScore(targetScore){};
+        void AddPopulation(AquariumCreatureType creature, int population);
+        // Carries score and live counters over when a reloaded level replaces this one.
+        void CopyProgressFrom(const AquariumLevel& other);
         void ConsumePopulation(AquariumCreatureType creature, int power);
         bool isCompleted() override;
         void populationReset();
         void levelReset(){m_level_score=0;this->populationReset();}
-        virtual std::vector<AquariumCreatureType> Repopulate(); // Originally set to 0, will now only be virtual with basic implementation.
+        // Appends whatever is missing to `out`. Only scans when something
+        // was eaten or reset since the last call, steady ticks are free.
+        virtual void Repopulate(std::vector<AquariumCreatureType>& out);
+        bool IsDirty() const { return m_dirty; }
+        int GetLevelScore() const { return m_level_score; }
+        const std::vector<AquariumLevelPopulationNode>& GetPopulation() const { return m_levelPopulation; }
+        void RestoreScore(int levelScore) { m_level_score = levelScore; }
+        void RestorePopulation(AquariumCreatureType creature, int currentPopulation);
     protected:
-        std::vector<std::shared_ptr<AquariumLevelPopulationNode>> m_levelPopulation;
+        std::vector<AquariumLevelPopulationNode> m_levelPopulation;
         int m_level_score;
         int m_targetScore;
+        bool m_dirty = true;
 
 };
 
 
+// Everything about the player besides movement, for snapshots.
+struct PlayerProgress {
+    int score = 0;
+    int lives = 3;
+    int power = 1;
+    int damageDebounce = 0;
+    int baseSpeed = 0;
+    int speedBoostFramesLeft = 0;
+};
+
 class PlayerCreature : public Creature {
 public:
 
-    PlayerCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
+    PlayerCreature(float x, float y, int speed, SpriteId sprite);
 
-    void move();
-    void draw() const;
-    void update();
+    void move(const WorldContext& world) override;
+    void draw() const override;
+    float getCollisionRadius() const override { return CollisionRadius; }
+    int getValue() const override { return 1; }
+    static constexpr float CollisionRadius = 10.0f;
+    void update(const WorldContext& world);
+    PlayerSnapshot snapshot() const;
     void changeSpeed(int speed);
     void setLives(int lives) { m_lives = lives; }
-    float getDx() { return m_dx; }
-    float getDy() { return m_dy; }
     void setDirection(float dx, float dy);
-    void setSprite(std::shared_ptr<GameSprite> new_sprite) { m_sprite = new_sprite; };
+    // Held boost, a bit faster while it lasts. Not saved in snapshots.
+    void setSprinting(bool sprinting) { m_sprinting = sprinting; }
+    static constexpr float SprintFactor = 1.5f;
 
     int getScore()const { return m_score; }
     int getLives() const { return m_lives; }
     int getPower() const { return m_power; }
+    int getSpeedBoostFramesLeft() const { return m_speed_boost_frames_left; }
     
     void addToScore(int amount, int weight=1) { m_score += amount * weight; }
     void loseLife(int debounce);
     void increasePower(int value) { m_power += value; }
     void reduceDamageDebounce();
     void applySpeedBoost(float factor, int durationFrames);
+
+    PlayerProgress getProgress() const;
+    void setProgress(const PlayerProgress& progress);
     
 private:
     int m_score = 0;
@@ -88,53 +116,77 @@ private:
     int m_damage_debounce = 0; // frames to wait after eating
     int m_base_speed_backup = 0;
     int m_speed_boost_frames_left = 0;
+    bool m_sprinting = false;
 };
 
+// Base for every aquarium creature except power ups. Radius and value come
+// from the type's archetype row.
 class NPCreature : public Creature {
 public:
-    NPCreature(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
-    AquariumCreatureType GetType() {return this->m_creatureType;}
-    void move() override;
+    NPCreature(AquariumCreatureType type, float x, float y, int speed, SpriteId sprite, GameRng& rng);
+    AquariumCreatureType GetType() const {return AquariumCreatureType(this->m_creatureType);}
     void draw() const override;
+    float getCollisionRadius() const override { return GetArchetype(this->GetType()).collisionRadius; }
+    int getValue() const override { return GetArchetype(this->GetType()).value; }
+    void steer(float dx, float dy) { m_dx = dx; m_dy = dy; } // heading from the schooling pass, already normalized
 
-    int getPlayerX();
-    int getPlayerY();
-    int getPlayerDirection(); // Returns -1 if the player is to the left of the creature, 1 if the player is to the right, and 0 if their x matches.
+    // Returns -1 if the player is to the left of the creature, 1 if the player is to the right, and 0 if their x matches.
+    int getPlayerDirection(const WorldContext& world) const;
 protected:
-    AquariumCreatureType m_creatureType;
+    uint16_t m_creatureType; // AquariumCreatureType, 16 bits fit in the base's padding
 };
 
-class BiggerFish : public NPCreature {
-public:
-    BiggerFish(float x, float y, int speed, std::shared_ptr<GameSprite> sprite);
-    void move() override;
-    void draw() const override;
-};
-
-class GroundCreature : public NPCreature {
+// Fish and crabs. Each type gets its own instantiation, so move() is built
+// with that type's speed scale and swim/walk choice as constants.
+template <AquariumCreatureType T>
+class ArchetypeCreature : public NPCreature {
     public:
-        GroundCreature(float x, float aquariumHeight, int speed, std::shared_ptr<GameSprite> sprite) 
-        : NPCreature(x, (int)(aquariumHeight * 0.71f), speed, sprite) { }
+        static constexpr const CreatureArchetype& Archetype = GetArchetype(T);
+        static_assert(Archetype.kind == CreatureKind::Swimmer || Archetype.kind == CreatureKind::Walker,
+                      "predators and power ups have their own classes");
+
+        // Walkers ignore y and stand on the floor of an aquarium this tall.
+        ArchetypeCreature(float x, float y, float aquariumHeight, int speed, SpriteId sprite, GameRng& rng)
+        : NPCreature(T, x, Archetype.kind == CreatureKind::Walker ? int(aquariumHeight * 0.71f) : y, speed, sprite, rng) {
+            if constexpr (Archetype.kind == CreatureKind::Walker) {
+                m_dx = (GameRandom::Below(rng, 2) == 0) ? 1 : -1;
+                m_dy = 0;
+            }
+        }
+
+        void move(const WorldContext& world) override { this->moveSteps(world, 1); }
+
+        // Straight line movers can take several ticks as one longer step.
+        void moveSteps(const WorldContext& world, int steps) override {
+            const float step = m_speed * Archetype.speedScale * steps;
+            this->setFlipped(Creature::StepStraight(m_x, m_y, m_dx, m_dy, step, Archetype.kind == CreatureKind::Swimmer,
+                                                    Archetype.collisionRadius, world.width, world.height));
+        }
+
+        float getCollisionRadius() const override { return Archetype.collisionRadius; }
+        int getValue() const override { return Archetype.value; }
 };
 
-class Crab : public GroundCreature {
-    public:
-        Crab(float x, float aquariumHeight, int speed, std::shared_ptr<GameSprite> sprite);
-        void move() override;
-        void draw() const override;
-};
+using BaseFish = ArchetypeCreature<AquariumCreatureType::NPCreature>;
+using BiggerFish = ArchetypeCreature<AquariumCreatureType::BiggerFish>;
+using Crab = ArchetypeCreature<AquariumCreatureType::Crab>;
 
 class SpeedPowerUp : public Creature {
 public:
+    static constexpr const CreatureArchetype& Archetype = GetArchetype(AquariumCreatureType::SpeedPowerUp);
+
     SpeedPowerUp(float x, float y)
-    : Creature(x, y, /*speed*/ 0, /*collisionRadius*/ 14.0f, /*value*/ 0, nullptr) {}
+    : Creature(x, y, /*speed*/ 0, /*sprite*/ 0) {}
 
-    void move() override {
+    void move(const WorldContext& world) override {
         // Gentle bob so it's not perfectly static
-        m_y += std::sin(ofGetElapsedTimef() * 2.f) * 0.25f;
-        this->bounce(); // Keep inside bounds just in case
+        m_y += std::sin(world.time * 2.f) * 0.25f;
+        this->bounce(world); // Keep inside bounds just in case
     }
 
+    float getCollisionRadius() const override { return Archetype.collisionRadius; }
+    int getValue() const override { return Archetype.value; }
+
     void draw() const override {
         // Bright yellow orb with white outline
         ofPushStyle();
@@ -149,24 +201,41 @@ public:
 
 class Predator : public NPCreature {
     public:
-        struct Segment {
-            ofVec2f position;
-        };
-
-        Predator(float x, float y, int speed,
-                  std::shared_ptr<GameSprite> head,
-                  std::shared_ptr<GameSprite> body,
-                  std::shared_ptr<GameSprite> tail,
-                  int bodyCount);
-        void move() override;
+        // type is Predator or BabyPredator, the body length comes from its row
+        Predator(AquariumCreatureType type, float x, float y, int speed,
+                  SpriteId head,
+                  SpriteId body,
+                  SpriteId tail,
+                  std::shared_ptr<PredatorChainPool> chainPool,
+                  GameRng& rng);
+        ~Predator() override;
+        void move(const WorldContext& world) override;
         void draw() const override;
-        std::vector<Predator::Segment> getSegments() { return m_segments; };
+        // Non-owning view into the aquarium chain pool, no copy is made.
+        ChainView getSegments() const { return m_chainPool->GetChain(m_chain); }
+        // Box around the whole body, kept up to date by move() and the
+        // pool's solve. Collisions check it before any segment.
+        ChainBounds getBounds() const { return m_chainPool->GetBounds(m_chain); }
+        // Replaces the whole body, used when restoring snapshots.
+        void restoreSegments(const float* xs, const float* ys, int count);
+        // Gives the body back to the pool while this predator sits unused.
+        void releaseSegments();
+        // Level of detail, 1 draws every body segment, 2 every other one...
+        void setDrawStep(int step) { m_drawStep = std::max(step, 1); }
+
+        static constexpr float SegmentSpacing = 40.0f;
+        // what the player has to come within to touch the head, body or tail
+        static constexpr float HeadHitRadius = 35.0f;
+        static constexpr float BodyHitRadius = 12.0f;
+        static constexpr float TailHitRadius = 15.0f;
+        static constexpr float MaxHitRadius = std::max({HeadHitRadius, BodyHitRadius, TailHitRadius});
     private:
 
-        std::vector<Segment> m_segments;
-        std::shared_ptr<GameSprite> m_bodySprite;
-        std::shared_ptr<GameSprite> m_tailSprite;
-        float m_segmentDistance = 40.0f;
+        std::shared_ptr<PredatorChainPool> m_chainPool;
+        PredatorChainPool::ChainId m_chain = PredatorChainPool::InvalidChain;
+        SpriteId m_bodySprite;
+        SpriteId m_tailSprite;
+        int m_drawStep = 1;
 
     };
 
@@ -174,135 +243,222 @@ class AquariumSpriteManager {
     public:
         AquariumSpriteManager();
         ~AquariumSpriteManager() = default;
-        std::shared_ptr<GameSprite>GetSprite(AquariumCreatureType t);
-        std::shared_ptr<GameSprite>GetPlayerSprite(PlayerType t);
+        // Ids into the SpriteTable, 0 for types drawn without a sprite.
+        SpriteId GetSprite(AquariumCreatureType t) const;
+        // 0 unless animations.xml has one named after the type.
+        AnimationId GetAnimation(AquariumCreatureType t) const;
+        SpriteId GetPlayerSprite(PlayerType t) const;
     private:
-        std::shared_ptr<GameSprite> m_player_fish;
-        std::shared_ptr<GameSprite> m_bigplayer_fish;
-        std::shared_ptr<GameSprite> m_biggerplayer_fish;
-
-        std::shared_ptr<GameSprite> m_npc_fish;
-        std::shared_ptr<GameSprite> m_big_fish;
-        std::shared_ptr<GameSprite> m_crab_fish;
-        std::shared_ptr<GameSprite> m_predator_head;
-        std::shared_ptr<GameSprite> m_predator_body;
-        std::shared_ptr<GameSprite> m_predator_tail;
+        SpriteId m_player_fish = 0;
+        SpriteId m_bigplayer_fish = 0;
+        SpriteId m_biggerplayer_fish = 0;
+
+        // loaded from the archetype table
+        SpriteId m_creatureSprites[size_t(AquariumCreatureType::Count)] = {};
+        AnimationId m_creatureAnimations[size_t(AquariumCreatureType::Count)] = {};
+};
+
+
+// One entry of the aquarium's draw list. Plain sprites are copied out so
+// drawing doesn't touch the creatures; anything fancier (predator chains,
+// power ups) keeps a pointer and draws itself.
+struct AquariumDrawItem {
+    const Creature* custom = nullptr;
+    float x = 0.0f;
+    float y = 0.0f;
+    SpriteId sprite = 0;
+    AnimationId animation = 0; // goes to the batch when set
+    uint16_t animationStart = 0;
+    bool flipped = false;
 };
 
+// Which creatures a moveCreatures call handles. Predators only chase the
+// player and feed the chain pool, so they can move while the fish school.
+enum class MoveGroup { Predators, Others };
+
+// What the predator bounds did for DetectAquariumCollisions: `culled`
+// predators were skipped on the box alone, `tested` went on to the
+// segments and `hits` of those really touched the player.
+struct PredatorCullStats {
+    uint64_t culled = 0;
+    uint64_t tested = 0;
+    uint64_t hits = 0;
+
+    double CullRate() const { return culled + tested ? double(culled) / double(culled + tested) : 0.0; }
+    // share of the box tests that passed but touched no segment
+    double FalsePositiveRate() const { return tested ? double(tested - hits) / double(tested) : 0.0; }
+};
 
 class Aquarium{
+    friend class AquariumSnapshot;
+    friend class AquariumMemory;
 public:
     Aquarium(int width, int height, std::shared_ptr<AquariumSpriteManager> spriteManager);
     void addCreature(std::shared_ptr<Creature> creature);
     void addAquariumLevel(std::shared_ptr<AquariumLevel> level);
+    // Rebuilds the levels from the table. Safe to call between ticks, live
+    // creatures and level progress are kept.
+    void setLevelTable(const LevelTable& table);
     void removeCreature(std::shared_ptr<Creature> creature);
+    void removeCreature(CreatureHandle handle);
+    CreatureHandle getHandleAt(int index) const;
+    // Null if the creature is gone.
+    Creature* resolve(CreatureHandle handle) const;
     void clearCreatures();
-    void update();
-    void draw() const;
-    void setBounds(int w, int h) { m_width = w; m_height = h; }
+    void update(const WorldContext& world);
+    // update() is these stages in this order. The task graph runs them
+    // itself: gatherSchooling first, then solve -> steer -> move Others on
+    // one side and move Predators -> solveChains on the other, both sides
+    // done before finishUpdate (power ups, repopulate).
+    void gatherSchooling(const WorldContext& world);
+    void solveSchooling();
+    void steerSchooling();
+    void moveCreatures(const WorldContext& world, MoveGroup group);
+    void solveChains();
+    void finishUpdate();
+    // Snapshot of what draw() shows. draw() falls back to walking the
+    // creatures when anything changed since.
+    void buildDrawList();
+    // Animated creatures go into `batch` when there is one, the caller
+    // draws it (Begin/End) around this. It gets flushed before every
+    // creature drawn directly, so nothing changes layers.
+    void draw(AnimationBatch* batch = nullptr) const;
+    void seed(uint32_t seed) { m_rng.seed(seed); }
+    void setEventBus(GameEventBus* bus) { m_eventBus = bus; }
+    GameRng& getRng() { return m_rng; }
     void setMaxPopulation(int n) { m_maxPopulation = n; }
     void Repopulate();
+    // Empties the tank and starts over from the first level.
+    void Reset();
     void SpawnCreature(AquariumCreatureType type);
+    SpawnScheduler& getSpawnScheduler() { return m_spawnScheduler; }
     std::shared_ptr<AquariumSpriteManager> getSpriteManager() { return m_sprite_manager; }
     std::shared_ptr<Creature> getCreatureAt(int index);
     int getCreatureCount() const { return m_creatures.size(); }
+    const std::vector<std::shared_ptr<Creature>>& getCreatures() const { return m_creatures; }
+    int getCurrentLevel() const { return currentLevel; }
+    SchoolingSystem& getSchooling() { return m_schooling; }
+    // Quality knobs for the frame pacer. Headless runs never touch them, so
+    // the simulation stays the same as before unless a window turns them down.
+    void setPredatorLod(int step);
+    void setFarUpdateInterval(int interval) { m_farUpdateInterval = std::max(interval, 1); }
+    // Counted since the aquarium was made, DetectAquariumCollisions adds to it.
+    PredatorCullStats& getPredatorCullStats() { return m_predatorCull; }
+    const PredatorCullStats& getPredatorCullStats() const { return m_predatorCull; }
 
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
 
 
 private:
+    std::shared_ptr<Creature> createCreature(AquariumCreatureType type, int x, int y, int speed);
+    // One instantiation per archetype row, createCreature picks from a table of them.
+    template <AquariumCreatureType T>
+    std::shared_ptr<Creature> createArchetype(int x, int y, int speed);
+    using ArchetypeFactory = std::shared_ptr<Creature> (Aquarium::*)(int, int, int);
+    template <size_t... I>
+    static constexpr std::array<ArchetypeFactory, sizeof...(I)> archetypeFactories(std::index_sequence<I...>) {
+        return {{ &Aquarium::createArchetype<AquariumCreatureType(I)>... }};
+    }
+    SpriteId spriteFor(AquariumCreatureType type) const;
+    // Snapshot loads reuse creatures from here instead of allocating new ones.
+    std::shared_ptr<Creature> acquirePooledCreature(AquariumCreatureType type);
+    void recycleAllCreatures();
+    int selectedLevelIndex() const { return this->currentLevel % this->m_aquariumlevels.size(); }
+
     int m_maxPopulation = 0;
     int m_width;
     int m_height;
     int currentLevel = 0;
     int m_powerupCooldownFrames = 0;
+    int m_predatorLodStep = 1;
+    int m_farUpdateInterval = 1;
+    float m_farDistance = 400.0f; // from the player, roughly half a screen
     std::vector<std::shared_ptr<Creature>> m_creatures;
     std::vector<std::shared_ptr<Creature>> m_next_creatures;
+    std::vector<std::shared_ptr<Creature>> m_creaturePool[size_t(AquariumCreatureType::Count)];
     std::vector<std::shared_ptr<AquariumLevel>> m_aquariumlevels;
+    LevelTable m_levelTable;
+    SpawnScheduler m_spawnScheduler;
+    std::vector<AquariumCreatureType> m_toRespawn; // scratch, reused every tick
     std::shared_ptr<AquariumSpriteManager> m_sprite_manager;
+    std::shared_ptr<PredatorChainPool> m_chainPool;
+    GameRng m_rng{std::random_device{}()};
+    GameEventBus* m_eventBus = nullptr;
+    uint32_t m_nextCreatureId = 0;
+    SchoolingSystem m_schooling;
+    std::vector<NPCreature*> m_schoolingFish; // same order as the fish in m_schooling
+    std::vector<Creature*> m_predators;       // split by gatherSchooling for the move stages
+    std::vector<Creature*> m_movers;
+    uint64_t m_tick = 0;    // of the last update, new creatures start animating from it
+    uint64_t m_version = 1; // bumped whenever creatures move, come or go
+    uint64_t m_drawListVersion = 0;
+    std::vector<AquariumDrawItem> m_drawList;
+    PredatorCullStats m_predatorCull;
 };
 
 
-std::shared_ptr<GameEvent> DetectAquariumCollisions(std::shared_ptr<Aquarium> aquarium, std::shared_ptr<PlayerCreature> player);
+// Returns the first collision of the tick, or a NONE event.
+GameEvent DetectAquariumCollisions(Aquarium& aquarium, PlayerCreature& player);
 
 
 class AquariumGameScene : public GameScene {
     public:
         AquariumGameScene(std::shared_ptr<PlayerCreature> player, std::shared_ptr<Aquarium> aquarium, string name)
         : m_player(std::move(player)) , m_aquarium(std::move(aquarium)), m_name(name){}
-        std::shared_ptr<GameEvent> GetLastEvent(){return m_lastEvent;}
-        void SetLastEvent(std::shared_ptr<GameEvent> event){this->m_lastEvent = event;}
+        // Gameplay events (hurt, eaten, power-up, level, game over) go here.
+        void SetEventBus(GameEventBus* bus){this->m_eventBus = bus; this->m_aquarium->setEventBus(bus);}
+        bool IsGameOver() const {return m_gameOver;}
+        AquariumHud& GetHud(){return this->m_hud;}
+        ParticleSystem& GetParticles(){return this->m_particles;}
+        // Particle budget and the aquarium's LOD/sub-rate, from the frame pacer.
+        void SetQuality(const QualitySettings& quality);
         std::shared_ptr<PlayerCreature> GetPlayer(){return this->m_player;}
         std::shared_ptr<Aquarium> GetAquarium(){return this->m_aquarium;}
         string GetName()override {return this->m_name;}
+        // Simulate() plus particles and the draw list, as a task graph on
+        // the scheduler (or in order on this thread without one). Stages
+        // are ordered so only one of them publishes at a time, and the bus
+        // only queues, listeners still run on the main thread.
         void Update() override;
         void Draw() override;
+        // One frame of gameplay, windowed or headless. The controller steers
+        // the player first; without one whoever calls this sets the
+        // player's direction.
+        void Simulate();
+        void SetScheduler(TaskScheduler* scheduler){this->m_scheduler = scheduler;}
+        // Per-task timings of the last Update.
+        const TaskGraph& GetFrameGraph() const {return this->m_frameGraph;}
+        void SetController(PlayerController* controller){this->m_controller = controller;}
+        PlayerController* GetController(){return this->m_controller;}
+        // Back to the first level with a fresh player, for bots that play
+        // game after game.
+        void Restart();
 
-        std::map<int, bool> keysDown;
-        
     private:
+        // the stages of a tick, Simulate and the frame graph both use them
+        void beginTick();
+        void collide();
+        void handleEvent();
+        void updateParticles();
+        void buildFrameGraph();
         void paintAquariumHUD();
+        AquariumHud m_hud;
+        ParticleSystem m_particles; // windowed only, Simulate() never touches it
+        AnimationBatch m_animations;
         std::shared_ptr<PlayerCreature> m_player;
         std::shared_ptr<Aquarium> m_aquarium;
-        std::shared_ptr<GameEvent> m_lastEvent;
+        void publish(const GameEvent& event){ if(m_eventBus){ m_eventBus->Publish(event); } }
+        GameEventBus* m_eventBus = nullptr;
+        PlayerController* m_controller = nullptr;
+        bool m_gameOver = false;
         string m_name;
         AwaitFrames updateControl{5};
-};
-
-
-// Deprecated Repopulate function from Level 0-5 classes,
-// as it was becoming too repetitive and a bit odd to 
-// comprehend it.
-
-class Level_0 : public AquariumLevel  {
-    public:
-        Level_0(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 10));
-        };
-
-};
-
-class Level_1 : public AquariumLevel  {
-    public:
-        Level_1(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::Crab, 3));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 20));
-
-        };
-};
-
-class Level_2 : public AquariumLevel  {
-    public:
-        Level_2(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::Predator, 1));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 30));
-
-        };
-
-};
-
-class Level_3 : public AquariumLevel {
-    public:
-        Level_3(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 30));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::BiggerFish, 5));
-        };
-};
-
-class Level_4 : public AquariumLevel {
-    public:
-        Level_4(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::Predator, 1));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::Crab, 2));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 30));
-        };
-};
-
-class Level_5 : public AquariumLevel {
-    public:
-        Level_5(int levelNumber, int targetScore): AquariumLevel(levelNumber, targetScore){
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::BabyPredator, 4));
-            this->m_levelPopulation.push_back(std::make_shared<AquariumLevelPopulationNode>(AquariumCreatureType::NPCreature, 30));
-        };
+        uint64_t m_tick = 0;
+        // state handed from one stage to the next
+        WorldContext m_world;
+        GameEvent m_event;
+        bool m_aquariumTick = false; // the aquarium updates this tick
+        TaskScheduler* m_scheduler = nullptr;
+        TaskGraph m_frameGraph;
 };
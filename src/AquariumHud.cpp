@@ -0,0 +1,52 @@
+#include "AquariumHud.h"
+
+void AquariumHud::Draw(float x, float y, HudFields fields) {
+    if (m_showFps) {
+        if (m_fps < 0 || ++m_framesSinceFps >= FpsSampleFrames) {
+            m_fps = int(ofGetFrameRate() + 0.5f);
+            m_framesSinceFps = 0;
+        }
+        fields.fps = m_fps;
+    }
+    else {
+        fields.fps = -1;
+        m_fps = -1;
+    }
+
+    if (!m_allocated) {
+        m_fbo.allocate(Width, Height, GL_RGBA);
+        m_allocated = true;
+        this->render(fields);
+    }
+    else if (fields != m_shown) {
+        this->render(fields);
+    }
+    m_fbo.draw(x - Margin, y);
+}
+
+void AquariumHud::render(const HudFields& fields) {
+    m_shown = fields;
+    ++m_redraws;
+
+    m_fbo.begin();
+    ofClear(0, 0, 0, 0);
+    ofPushStyle();
+    ofSetColor(ofColor::white);
+    ofDrawBitmapString("Score: " + std::to_string(fields.score), Margin, 20);
+    ofDrawBitmapString("Power: " + std::to_string(fields.power), Margin, 30);
+    ofDrawBitmapString("Lives: " + std::to_string(fields.lives), Margin, 40);
+    ofSetColor(ofColor::red);
+    for (int i = 0; i < fields.lives; ++i) {
+        ofDrawCircle(Margin + i * 20, 50, 5);
+    }
+    ofSetColor(ofColor::white);
+    ofDrawBitmapString("Level: " + std::to_string(fields.level + 1), Margin, 70);
+    if (fields.boostSeconds > 0) {
+        ofDrawBitmapString("Boost: " + std::to_string(fields.boostSeconds) + "s", Margin, 80);
+    }
+    if (fields.fps >= 0) {
+        ofDrawBitmapString("FPS: " + std::to_string(fields.fps), Margin, 90);
+    }
+    ofPopStyle();
+    m_fbo.end();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ofMain.h"
+
+// What the HUD shows. Everything is an int so comparing two frames is cheap
+// and the cached image is only redrawn when something actually changed.
+struct HudFields {
+    int score = 0;
+    int power = 0;
+    int lives = 0;
+    int level = 0;
+    int boostSeconds = 0; // 0 hides the boost line
+    int fps = -1;         // -1 hides the fps line
+
+    bool operator==(const HudFields& other) const {
+        return score == other.score && power == other.power && lives == other.lives &&
+               level == other.level && boostSeconds == other.boostSeconds && fps == other.fps;
+    }
+    bool operator!=(const HudFields& other) const { return !(*this == other); }
+};
+
+// Score/power/lives panel rendered into an ofFbo. The text and the life
+// circles are only drawn again when the fields change; every other frame
+// is one textured quad.
+class AquariumHud {
+    public:
+        static constexpr int Width = 160;
+        static constexpr int Height = 100;
+        static constexpr int Margin = 10;       // room for the life circles left of the text
+        static constexpr int FpsSampleFrames = 30; // fps readings jitter, only take one twice a second
+
+        // x, y is where the text column starts, same as the old HUD.
+        void Draw(float x, float y, HudFields fields);
+
+        void SetShowFps(bool show) { m_showFps = show; }
+        bool IsShowingFps() const { return m_showFps; }
+        int GetRedrawCount() const { return m_redraws; }
+
+    private:
+        void render(const HudFields& fields);
+
+        ofFbo m_fbo;
+        bool m_allocated = false;
+        HudFields m_shown;
+        bool m_showFps = false;
+        int m_fps = -1;
+        int m_framesSinceFps = 0;
+        int m_redraws = 0;
+};
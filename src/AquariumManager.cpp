@@ -0,0 +1,110 @@
+#include "AquariumManager.h"
+#include <cmath>
+#include <cstdio>
+
+AquariumManager::~AquariumManager() {
+    // tasks point into the tanks, let them finish first
+    if (m_running) { this->Wait(); }
+}
+
+size_t AquariumManager::AddTank(const LevelTable& levels, uint32_t seed, std::unique_ptr<PlayerController> controller,
+                                std::shared_ptr<AquariumSpriteManager> sprites) {
+    auto tank = std::make_unique<Tank>();
+    tank->aquarium = std::make_shared<Aquarium>(WorldWidth, WorldHeight, sprites);
+    tank->aquarium->seed(seed);
+    tank->aquarium->setLevelTable(levels);
+    SpriteId look = sprites ? sprites->GetPlayerSprite(PlayerType::Pirahna) : 0;
+    tank->player = std::make_shared<PlayerCreature>(WorldWidth / 2 - 50, WorldHeight / 2 - 50, levels.playerSpeed, look);
+    tank->aquarium->Repopulate();
+    tank->scene = std::make_unique<AquariumGameScene>(tank->player, tank->aquarium, "tank " + std::to_string(m_tanks.size()));
+    tank->controller = std::move(controller);
+    tank->scene->SetController(tank->controller.get());
+    m_tanks.push_back(std::move(tank));
+    return m_tanks.size() - 1;
+}
+
+void AquariumManager::SetLevelTable(const LevelTable& levels) {
+    for (auto& tank : m_tanks) {
+        tank->aquarium->setLevelTable(levels);
+    }
+}
+
+void AquariumManager::tick(Tank& tank) {
+    auto start = std::chrono::steady_clock::now();
+    tank.scene->Simulate();
+    if (tank.scene->IsGameOver() && m_restartOnGameOver) {
+        ++tank.games;
+        tank.scene->Restart();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    TankTiming& timing = tank.timing;
+    timing.lastMs = ms;
+    timing.avgMs = timing.ticks == 0 ? ms : timing.avgMs + (ms - timing.avgMs) * 0.05;
+    timing.maxMs = std::max(timing.maxMs, ms);
+    timing.worker = m_scheduler.GetCurrentWorker();
+    ++timing.ticks;
+}
+
+void AquariumManager::Launch() {
+    if (m_running) { return; }
+    m_running = true;
+    m_launchedAt = std::chrono::steady_clock::now();
+    for (auto& tank : m_tanks) {
+        Tank* t = tank.get();
+        m_scheduler.Spawn(m_group, [this, t] { this->tick(*t); });
+    }
+}
+
+void AquariumManager::Wait() {
+    if (!m_running) { return; }
+    m_scheduler.Wait(m_group);
+    m_running = false;
+    m_lastStepMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_launchedAt).count();
+}
+
+ofRectangle AquariumManager::GetTile(size_t index, size_t count, const ofRectangle& area) {
+    size_t columns = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(count)))));
+    size_t rows = (count + columns - 1) / columns;
+    float w = area.width / columns;
+    float h = area.height / std::max<size_t>(rows, 1);
+    return ofRectangle(area.x + (index % columns) * w, area.y + (index / columns) * h, w, h);
+}
+
+void AquariumManager::DrawTank(size_t tank, const ofRectangle& tile, const ofImage* background) {
+    WorldView view;
+    view.SetTarget(tile);
+    view.Begin();
+    if (background) {
+        ofSetColor(ofColor::white);
+        background->draw(0, 0, WorldWidth, WorldHeight);
+    }
+    m_tanks[tank]->scene->Draw();
+    view.End();
+
+    const TankTiming& timing = m_tanks[tank]->timing;
+    char label[96];
+    std::snprintf(label, sizeof(label), "%s  %.2f ms (max %.2f)  worker %d", m_tanks[tank]->scene->GetName().c_str(),
+                  timing.avgMs, timing.maxMs, timing.worker);
+    ofDrawBitmapStringHighlight(label, view.GetViewport().x + 6, view.GetViewport().y + 16);
+}
+
+void AquariumManager::Draw(const ofRectangle& area, const ofImage* background) {
+    for (size_t i = 0; i < m_tanks.size(); ++i) {
+        this->DrawTank(i, GetTile(i, m_tanks.size(), area), background);
+    }
+}
+
+void AquariumManager::PrintTimings(std::ostream& out) const {
+    double total = 0.0;
+    for (const auto& tank : m_tanks) { total += tank->timing.avgMs; }
+    char line[128];
+    std::snprintf(line, sizeof(line), "[tanks] %zu tanks on %u threads, step %.2f ms, tanks add up to %.2f ms", m_tanks.size(),
+                  m_scheduler.GetThreadCount(), m_lastStepMs, total);
+    out << line << std::endl;
+    for (const auto& tank : m_tanks) {
+        std::snprintf(line, sizeof(line), "  %-8s avg %.3f ms  max %.3f ms  worker %d  games %d", tank->scene->GetName().c_str(),
+                      tank->timing.avgMs, tank->timing.maxMs, tank->timing.worker, tank->games);
+        out << line << std::endl;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "Aquarium.h"
+#include "TaskScheduler.h"
+
+// How long one tank's ticks take and where they ran.
+struct TankTiming {
+    double lastMs = 0.0;
+    double avgMs = 0.0;   // moving average over roughly the last second
+    double maxMs = 0.0;
+    int worker = 0;       // scheduler thread of the last tick
+    uint64_t ticks = 0;
+};
+
+// Any number of independent tanks in one process, for split screen,
+// spectating bots or batched headless runs. Each tank has its own aquarium,
+// levels, RNG, player and controller, so ticking them all at once on the
+// task scheduler needs no locks. Tanks only share the read-only sprites.
+class AquariumManager {
+    public:
+        explicit AquariumManager(TaskScheduler& scheduler = TaskScheduler::Shared()) : m_scheduler(scheduler) {}
+        ~AquariumManager();
+
+        // Returns the tank's index. A null controller leaves the player
+        // wherever it is; null sprites make a headless tank.
+        size_t AddTank(const LevelTable& levels, uint32_t seed, std::unique_ptr<PlayerController> controller,
+                       std::shared_ptr<AquariumSpriteManager> sprites = nullptr);
+        size_t GetTankCount() const { return m_tanks.size(); }
+        AquariumGameScene& GetScene(size_t tank) { return *m_tanks[tank]->scene; }
+        const TankTiming& GetTiming(size_t tank) const { return m_tanks[tank]->timing; }
+        int GetGamesPlayed(size_t tank) const { return m_tanks[tank]->games; }
+        // Bot tanks start over when their game ends instead of stopping.
+        void SetRestartOnGameOver(bool restart) { m_restartOnGameOver = restart; }
+        // Between ticks only, like the single aquarium's hot reload.
+        void SetLevelTable(const LevelTable& levels);
+
+        // One tick of every tank, a task each. Launch returns right away so
+        // the caller can do its own work meanwhile, Wait helps until all are
+        // done. Step is both.
+        void Launch();
+        void Wait();
+        void Step() { this->Launch(); this->Wait(); }
+        // Wall time of the last Launch to Wait.
+        double GetLastStepMs() const { return m_lastStepMs; }
+
+        // Tile `index` of `count` over `area`, as square a grid as fits.
+        static ofRectangle GetTile(size_t index, size_t count, const ofRectangle& area);
+        // One tank letterboxed into `tile`, with its timing in the corner.
+        void DrawTank(size_t tank, const ofRectangle& tile, const ofImage* background = nullptr);
+        // Every tank, tiled over `area`.
+        void Draw(const ofRectangle& area, const ofImage* background = nullptr);
+
+        void PrintTimings(std::ostream& out) const;
+
+    private:
+        struct Tank {
+            std::shared_ptr<Aquarium> aquarium;
+            std::shared_ptr<PlayerCreature> player;
+            std::unique_ptr<AquariumGameScene> scene;
+            std::unique_ptr<PlayerController> controller;
+            TankTiming timing;
+            int games = 0;
+        };
+        void tick(Tank& tank);
+
+        TaskScheduler& m_scheduler;
+        TaskScheduler::TaskGroup m_group;
+        std::vector<std::unique_ptr<Tank>> m_tanks;
+        bool m_restartOnGameOver = false;
+        bool m_running = false;
+        std::chrono::steady_clock::time_point m_launchedAt;
+        double m_lastStepMs = 0.0;
+};
@@ -0,0 +1,314 @@
+#include "AquariumSnapshot.h"
+#include "Aquarium.h"
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+namespace {
+
+const char SnapshotMagic[4] = {'A', 'Q', 'S', 'N'};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t levelCount;
+    uint32_t creatureCount;
+    uint32_t pendingSpawnCount;
+    int32_t currentLevel;
+    int32_t powerupCooldownFrames;
+};
+
+struct LevelRecord {
+    int32_t levelScore;
+    uint32_t nodeCount;
+};
+
+struct NodeRecord {
+    uint8_t creatureType;
+    uint8_t padding[3];
+    int32_t currentPopulation;
+};
+
+struct CreatureRecord {
+    uint8_t creatureType;
+    uint8_t padding;
+    uint16_t segmentCount;
+    CreatureState state;
+};
+
+// Every record is a multiple of 4 bytes, so segment floats inside a loaded
+// buffer stay 4-byte aligned and can be read in place.
+static_assert(sizeof(SnapshotHeader) % 4 == 0, "snapshot records must keep floats aligned");
+static_assert(sizeof(CreatureState) % 4 == 0, "snapshot records must keep floats aligned");
+static_assert(sizeof(PlayerProgress) % 4 == 0, "snapshot records must keep floats aligned");
+static_assert(sizeof(LevelRecord) % 4 == 0, "snapshot records must keep floats aligned");
+static_assert(sizeof(NodeRecord) % 4 == 0, "snapshot records must keep floats aligned");
+static_assert(sizeof(CreatureRecord) % 4 == 0, "snapshot records must keep floats aligned");
+
+// Appends raw bytes; the buffer only grows so later saves reuse it.
+class ByteWriter {
+    public:
+        explicit ByteWriter(std::vector<uint8_t>& out) : m_out(out) { m_out.clear(); }
+        template <typename T>
+        void Write(const T& value) { WriteBytes(&value, sizeof(T)); }
+        void WriteBytes(const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            m_out.insert(m_out.end(), bytes, bytes + size);
+        }
+    private:
+        std::vector<uint8_t>& m_out;
+};
+
+// Lets the engine's operator<< write its text straight into the snapshot
+// buffer, so saving the random state doesn't build a temporary string.
+class ByteStreamBuf : public std::streambuf {
+    public:
+        explicit ByteStreamBuf(std::vector<uint8_t>& out) : m_out(out) {}
+    protected:
+        int_type overflow(int_type c) override {
+            if (!traits_type::eq_int_type(c, traits_type::eof())) { m_out.push_back(uint8_t(c)); }
+            return traits_type::not_eof(c);
+        }
+        std::streamsize xsputn(const char* s, std::streamsize n) override {
+            m_out.insert(m_out.end(), s, s + n);
+            return n;
+        }
+    private:
+        std::vector<uint8_t>& m_out;
+};
+
+class ByteReader {
+    public:
+        ByteReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+        size_t Position() const { return m_pos; }
+        template <typename T>
+        bool Read(T& value) { return ReadBytes(&value, sizeof(T)); }
+        bool ReadBytes(void* out, size_t size) {
+            if (m_pos + size > m_size) { return false; }
+            std::memcpy(out, m_data + m_pos, size);
+            m_pos += size;
+            return true;
+        }
+        // Points straight into the buffer instead of copying.
+        const uint8_t* Borrow(size_t size) {
+            if (m_pos + size > m_size) { return nullptr; }
+            const uint8_t* at = m_data + m_pos;
+            m_pos += size;
+            return at;
+        }
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+};
+
+bool ValidType(uint8_t type) {
+    return type < uint8_t(AquariumCreatureType::Count);
+}
+
+AquariumCreatureType TypeOf(const Creature& creature) {
+    if (auto npc = dynamic_cast<const NPCreature*>(&creature)) {
+        return npc->GetType();
+    }
+    return AquariumCreatureType::SpeedPowerUp;
+}
+
+}
+
+void AquariumSnapshot::Save(const Aquarium& aquarium, const PlayerCreature& player, std::vector<uint8_t>& out) {
+    ByteWriter writer(out);
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = Version;
+    header.levelCount = uint32_t(aquarium.m_aquariumlevels.size());
+    header.creatureCount = uint32_t(aquarium.m_creatures.size());
+    header.pendingSpawnCount = uint32_t(aquarium.m_spawnScheduler.Pending());
+    header.currentLevel = aquarium.currentLevel;
+    header.powerupCooldownFrames = aquarium.m_powerupCooldownFrames;
+    writer.Write(header);
+
+    writer.Write(player.getState());
+    writer.Write(player.getProgress());
+
+    for (const auto& level : aquarium.m_aquariumlevels) {
+        const std::vector<AquariumLevelPopulationNode>& nodes = level->GetPopulation();
+        writer.Write(LevelRecord{ level->GetLevelScore(), uint32_t(nodes.size()) });
+        for (const AquariumLevelPopulationNode& node : nodes) {
+            NodeRecord record = {};
+            record.creatureType = uint8_t(node.creatureType);
+            record.currentPopulation = node.currentPopulation;
+            writer.Write(record);
+        }
+    }
+
+    for (const auto& creature : aquarium.m_creatures) {
+        CreatureRecord record = {};
+        record.creatureType = uint8_t(TypeOf(*creature));
+        record.state = creature->getState();
+        const Predator* predator = dynamic_cast<const Predator*>(creature.get());
+        ChainView segments = predator ? predator->getSegments() : ChainView();
+        record.segmentCount = uint16_t(segments.size());
+        writer.Write(record);
+        if (record.segmentCount > 0) {
+            writer.WriteBytes(segments.xs, segments.size() * sizeof(float));
+            writer.WriteBytes(segments.ys, segments.size() * sizeof(float));
+        }
+    }
+
+    aquarium.m_spawnScheduler.ForEachPending([&writer](AquariumCreatureType type) {
+        writer.Write(uint8_t(type));
+    });
+
+    // length goes in front, so reserve it and fill it in afterwards
+    const size_t lengthAt = out.size();
+    writer.Write(uint32_t(0));
+    ByteStreamBuf buffer(out);
+    std::ostream rng(&buffer);
+    rng << aquarium.m_rng;
+    const uint32_t length = uint32_t(out.size() - lengthAt - sizeof(uint32_t));
+    std::memcpy(out.data() + lengthAt, &length, sizeof(length));
+}
+
+bool AquariumSnapshot::Load(Aquarium& aquarium, PlayerCreature& player, const std::vector<uint8_t>& data, std::string& error) {
+    ByteReader reader(data.data(), data.size());
+
+    SnapshotHeader header;
+    if (!reader.Read(header) || std::memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) != 0) {
+        error = "not an aquarium snapshot";
+        return false;
+    }
+    if (header.version != Version) {
+        error = "snapshot version " + std::to_string(header.version) + " is not supported";
+        return false;
+    }
+    if (header.levelCount != aquarium.m_aquariumlevels.size()) {
+        error = "snapshot has " + std::to_string(header.levelCount) + " levels, the aquarium has "
+              + std::to_string(aquarium.m_aquariumlevels.size());
+        return false;
+    }
+
+    // validate the whole buffer before touching any state
+    CreatureState playerState;
+    PlayerProgress progress;
+    bool ok = reader.Read(playerState) && reader.Read(progress);
+
+    const size_t levelsAt = reader.Position();
+    for (uint32_t l = 0; ok && l < header.levelCount; ++l) {
+        LevelRecord level;
+        ok = reader.Read(level);
+        for (uint32_t n = 0; ok && n < level.nodeCount; ++n) {
+            NodeRecord node;
+            ok = reader.Read(node) && ValidType(node.creatureType);
+        }
+    }
+
+    const size_t creaturesAt = reader.Position();
+    for (uint32_t c = 0; ok && c < header.creatureCount; ++c) {
+        CreatureRecord record;
+        ok = reader.Read(record) && ValidType(record.creatureType)
+             && reader.Borrow(size_t(record.segmentCount) * 2 * sizeof(float)) != nullptr;
+    }
+
+    const size_t spawnsAt = reader.Position();
+    const uint8_t* spawns = ok ? reader.Borrow(header.pendingSpawnCount) : nullptr;
+    ok = spawns != nullptr;
+    for (uint32_t s = 0; ok && s < header.pendingSpawnCount; ++s) {
+        ok = ValidType(spawns[s]);
+    }
+
+    // parsed into a spare engine so a bad one leaves the aquarium's alone
+    GameRng rng;
+    uint32_t rngSize = 0;
+    const uint8_t* rngText = ok && reader.Read(rngSize) ? reader.Borrow(rngSize) : nullptr;
+    if (rngText) {
+        std::istringstream in(std::string(reinterpret_cast<const char*>(rngText), rngSize));
+        ok = bool(in >> rng);
+    } else {
+        ok = false;
+    }
+    if (!ok) {
+        error = "snapshot is truncated or corrupt";
+        return false;
+    }
+
+    // everything checked, now apply it in one pass
+    player.setState(playerState);
+    player.setProgress(progress);
+    if (auto sprites = aquarium.getSpriteManager()) {
+        PlayerType look = progress.power >= 10 ? PlayerType::Whale : progress.power >= 5 ? PlayerType::Shark : PlayerType::Pirahna;
+        player.setSprite(sprites->GetPlayerSprite(look));
+    }
+
+    aquarium.currentLevel = header.currentLevel;
+    aquarium.m_powerupCooldownFrames = header.powerupCooldownFrames;
+
+    ByteReader levels(data.data() + levelsAt, creaturesAt - levelsAt);
+    for (const auto& level : aquarium.m_aquariumlevels) {
+        LevelRecord record;
+        levels.Read(record);
+        level->levelReset();
+        level->RestoreScore(record.levelScore);
+        for (uint32_t n = 0; n < record.nodeCount; ++n) {
+            NodeRecord node;
+            levels.Read(node);
+            level->RestorePopulation(AquariumCreatureType(node.creatureType), node.currentPopulation);
+        }
+    }
+
+    // park every live creature, then pull from the pool per record
+    aquarium.recycleAllCreatures();
+    ByteReader creatures(data.data() + creaturesAt, spawnsAt - creaturesAt);
+    for (uint32_t c = 0; c < header.creatureCount; ++c) {
+        CreatureRecord record;
+        creatures.Read(record);
+        const float* xs = reinterpret_cast<const float*>(creatures.Borrow(record.segmentCount * sizeof(float)));
+        const float* ys = reinterpret_cast<const float*>(creatures.Borrow(record.segmentCount * sizeof(float)));
+        std::shared_ptr<Creature> creature = aquarium.acquirePooledCreature(AquariumCreatureType(record.creatureType));
+        if (!creature) { continue; }
+        creature->setState(record.state);
+        if (auto predator = dynamic_cast<Predator*>(creature.get())) {
+            predator->restoreSegments(xs, ys, record.segmentCount);
+        }
+        aquarium.addCreature(creature);
+    }
+
+    aquarium.m_spawnScheduler.Clear();
+    for (uint32_t s = 0; s < header.pendingSpawnCount; ++s) {
+        aquarium.m_spawnScheduler.Enqueue(AquariumCreatureType(spawns[s]));
+    }
+
+    // last, building creatures from the pool above draws from the engine
+    aquarium.m_rng = rng;
+    return true;
+}
+
+bool AquariumSnapshot::SaveToFile(const std::string& path, const Aquarium& aquarium, const PlayerCreature& player, std::vector<uint8_t>& buffer) {
+    Save(aquarium, player, buffer);
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) { return false; }
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool AquariumSnapshot::LoadFromFile(const std::string& path, Aquarium& aquarium, PlayerCreature& player, std::vector<uint8_t>& buffer, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "could not open " + path;
+        return false;
+    }
+    // one read for the whole file
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    buffer.resize(size > 0 ? size_t(size) : 0);
+    bool ok = size > 0 && std::fread(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    std::fclose(file);
+    if (!ok) {
+        error = "could not read " + path;
+        return false;
+    }
+    return Load(aquarium, player, buffer, error);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Aquarium;
+class PlayerCreature;
+
+// Compact binary save state of a running aquarium and its player.
+//
+// Checkpoints for the machine that wrote them: records are host structs in
+// host byte order, nothing is swapped. Layout (version 2):
+//   Header            magic "AQSN", version, counts
+//   World             current level, power-up cooldown
+//   Player            CreatureState + PlayerProgress
+//   Levels            per level: score, then (type, current population) pairs
+//   Creatures         per creature: type, segment count, CreatureState,
+//                     then segment xs[] and ys[] for predators
+//   Pending spawns    one byte per queued creature type
+//   Random state      length, then the aquarium's engine as text (the
+//                     standard fixes that format), so a loaded game draws
+//                     the same numbers the saved one would have
+//
+// Saving and loading work on a byte buffer the caller keeps around, so
+// repeated checkpoints don't allocate once the buffer has grown (the
+// random state is streamed straight into it too).
+class AquariumSnapshot {
+    public:
+        static constexpr uint32_t Version = 2;
+
+        static void Save(const Aquarium& aquarium, const PlayerCreature& player, std::vector<uint8_t>& out);
+        // Returns false and leaves the aquarium untouched if the data is not a
+        // valid snapshot of this version.
+        static bool Load(Aquarium& aquarium, PlayerCreature& player, const std::vector<uint8_t>& data, std::string& error);
+
+        static bool SaveToFile(const std::string& path, const Aquarium& aquarium, const PlayerCreature& player, std::vector<uint8_t>& buffer);
+        static bool LoadFromFile(const std::string& path, Aquarium& aquarium, PlayerCreature& player, std::vector<uint8_t>& buffer, std::string& error);
+};
@@ -0,0 +1,159 @@
+#include "AudioEngine.h"
+
+namespace {
+
+const float Tau = 6.2831853f;
+
+// Sine sweep from f0 to f1 Hz with an exponential decay, the basic blip.
+void AddSweep(std::vector<float>& out, int sampleRate, float start, float seconds, float f0, float f1, float volume, float decay) {
+    size_t first = size_t(start * sampleRate);
+    size_t count = size_t(seconds * sampleRate);
+    if (out.size() < first + count) { out.resize(first + count, 0.0f); }
+    float phase = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        float t = float(i) / count;
+        float freq = f0 + (f1 - f0) * t;
+        phase += Tau * freq / sampleRate;
+        float attack = std::min(1.0f, i / (0.005f * sampleRate)); // 5 ms, avoids a click
+        out[first + i] += std::sin(phase) * volume * attack * std::exp(-decay * t);
+    }
+}
+
+}
+
+AudioEngine::~AudioEngine() {
+    this->Close();
+}
+
+bool AudioEngine::Setup(int sampleRate, int bufferSize) {
+    m_sampleRate = sampleRate;
+    m_bufferSize = bufferSize;
+    this->synthesize();
+
+    ofSoundStreamSettings settings;
+    settings.numOutputChannels = 2;
+    settings.numInputChannels = 0;
+    settings.sampleRate = sampleRate;
+    settings.bufferSize = bufferSize;
+    settings.numBuffers = 2;
+    settings.setOutListener(this);
+    m_running = m_stream.setup(settings);
+    if (!m_running) {
+        ofLogError() << "AudioEngine: could not open the sound stream, effects are off";
+    }
+    return m_running;
+}
+
+void AudioEngine::Close() {
+    if (m_running) {
+        m_stream.close();
+        m_running = false;
+    }
+    m_ambient.stop();
+}
+
+bool AudioEngine::StartAmbient(const std::string& path, float volume) {
+    if (!m_ambient.load(path, true)) { // true = stream from disk
+        return false;
+    }
+    m_ambient.setLoop(true);
+    m_ambient.setMultiPlay(false);
+    m_ambient.setVolume(volume);
+    m_ambient.play();
+    return true;
+}
+
+void AudioEngine::synthesize() {
+    const int rate = m_sampleRate;
+    std::vector<float>& eat = m_effects[size_t(SoundEffect::Eat)];
+    AddSweep(eat, rate, 0.0f, 0.08f, 420, 900, 0.5f, 4);
+
+    std::vector<float>& hurt = m_effects[size_t(SoundEffect::Hurt)];
+    AddSweep(hurt, rate, 0.0f, 0.25f, 180, 90, 0.6f, 3);
+    AddSweep(hurt, rate, 0.0f, 0.25f, 271, 133, 0.3f, 3); // off-key partial so it sounds wrong
+
+    std::vector<float>& powerUp = m_effects[size_t(SoundEffect::PowerUp)];
+    const float arpeggio[] = {523.3f, 659.3f, 784.0f, 1046.5f};
+    for (int n = 0; n < 4; ++n) {
+        AddSweep(powerUp, rate, n * 0.07f, 0.12f, arpeggio[n], arpeggio[n], 0.4f, 3);
+    }
+
+    std::vector<float>& levelUp = m_effects[size_t(SoundEffect::LevelUp)];
+    const float chord[] = {392.0f, 493.9f, 587.3f};
+    for (float freq : chord) {
+        AddSweep(levelUp, rate, 0.0f, 0.6f, freq, freq, 0.25f, 4);
+        AddSweep(levelUp, rate, 0.15f, 0.45f, freq * 2, freq * 2, 0.12f, 5);
+    }
+}
+
+void AudioEngine::Play(SoundEffect effect, float gain) {
+    if (!m_running) { return; }
+    if (!m_commands.Push(Command{effect, gain, Clock::now()})) {
+        m_queueFull.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+AudioEngine::Voice& AudioEngine::freeVoice() {
+    Voice* oldest = &m_voices[0];
+    for (Voice& voice : m_voices) {
+        if (voice.samples == nullptr) { return voice; }
+        if (voice.started < oldest->started) { oldest = &voice; }
+    }
+    m_stolen.fetch_add(1, std::memory_order_relaxed);
+    return *oldest;
+}
+
+void AudioEngine::audioOut(ofSoundBuffer& buffer) {
+    const Clock::time_point now = Clock::now();
+    // what we write now is heard after this buffer has played out
+    const uint64_t bufferMicros = uint64_t(buffer.getNumFrames()) * 1000000 / buffer.getSampleRate();
+
+    Command command;
+    while (m_commands.Pop(command)) {
+        const std::vector<float>& samples = m_effects[size_t(command.effect)];
+        Voice& voice = this->freeVoice();
+        voice.samples = samples.data();
+        voice.length = samples.size();
+        voice.position = 0;
+        voice.gain = command.gain;
+        voice.started = ++m_voiceCounter;
+
+        uint64_t latency = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - command.requested).count()) + bufferMicros;
+        m_latencySumMicros.fetch_add(latency, std::memory_order_relaxed);
+        if (latency > m_latencyMaxMicros.load(std::memory_order_relaxed)) {
+            m_latencyMaxMicros.store(latency, std::memory_order_relaxed); // only this thread writes it
+        }
+        m_played.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const size_t frames = buffer.getNumFrames();
+    const size_t channels = buffer.getNumChannels();
+    for (size_t frame = 0; frame < frames; ++frame) {
+        float mix = 0.0f;
+        for (Voice& voice : m_voices) {
+            if (voice.samples == nullptr) { continue; }
+            mix += voice.samples[voice.position] * voice.gain;
+            if (++voice.position == voice.length) { voice.samples = nullptr; }
+        }
+        mix = std::max(-1.0f, std::min(1.0f, mix));
+        for (size_t c = 0; c < channels; ++c) {
+            buffer[frame * channels + c] = mix;
+        }
+    }
+}
+
+AudioEngine::Stats AudioEngine::GetStats() const {
+    Stats stats;
+    for (const std::vector<float>& samples : m_effects) {
+        stats.effectBytes += samples.capacity() * sizeof(float);
+    }
+    stats.voiceBytes = sizeof(m_voices) + sizeof(m_commands);
+    stats.played = m_played.load();
+    stats.queueFull = m_queueFull.load();
+    stats.stolen = m_stolen.load();
+    if (stats.played > 0) {
+        stats.avgLatencyMs = m_latencySumMicros.load() / 1000.0 / stats.played;
+    }
+    stats.maxLatencyMs = m_latencyMaxMicros.load() / 1000.0;
+    return stats;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "ofMain.h"
+#include "SpscQueue.h"
+
+enum class SoundEffect {
+    Eat,
+    Hurt,
+    PowerUp,
+    LevelUp,
+    Count
+};
+
+// Game audio. The ambient track is streamed from disk by ofSoundPlayer
+// instead of being decoded into memory up front. Short effects are
+// synthesized once at setup and mixed into a fixed pool of voices on the
+// sound stream's thread. The game thread only pushes small commands into a
+// lock-free queue, so Play() never blocks and the audio thread never
+// allocates.
+class AudioEngine : public ofBaseSoundOutput {
+    public:
+        struct Stats {
+            size_t effectBytes = 0;   // synthesized effect samples
+            size_t voiceBytes = 0;    // voice pool + command queue
+            uint64_t played = 0;
+            uint64_t queueFull = 0;   // Play() calls dropped because the queue was full
+            uint64_t stolen = 0;      // voices cut short to make room
+            double avgLatencyMs = 0;  // Play() until the sound leaves the mixer
+            double maxLatencyMs = 0;
+        };
+
+        static constexpr int MaxVoices = 16;
+
+        ~AudioEngine();
+
+        bool Setup(int sampleRate = 44100, int bufferSize = 256);
+        void Close();
+
+        // streamed, not loaded whole
+        bool StartAmbient(const std::string& path, float volume);
+
+        // Game thread. Safe to call any time, drops the sound if the queue is full.
+        void Play(SoundEffect effect, float gain = 1.0f);
+
+        // Audio thread.
+        void audioOut(ofSoundBuffer& buffer) override;
+
+        Stats GetStats() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Command {
+            SoundEffect effect;
+            float gain;
+            Clock::time_point requested;
+        };
+
+        struct Voice {
+            const float* samples = nullptr;
+            size_t length = 0;
+            size_t position = 0;
+            float gain = 0.0f;
+            uint64_t started = 0; // lower is older, used to pick a voice to steal
+        };
+
+        void synthesize();
+        Voice& freeVoice();
+
+        int m_sampleRate = 44100;
+        int m_bufferSize = 256;
+        bool m_running = false;
+
+        ofSoundStream m_stream;
+        ofSoundPlayer m_ambient;
+
+        std::vector<float> m_effects[size_t(SoundEffect::Count)]; // mono samples
+        SpscQueue<Command, 64> m_commands;
+
+        // only touched by the audio thread
+        Voice m_voices[MaxVoices];
+        uint64_t m_voiceCounter = 0;
+
+        std::atomic<uint64_t> m_played{0};
+        std::atomic<uint64_t> m_queueFull{0};
+        std::atomic<uint64_t> m_stolen{0};
+        std::atomic<uint64_t> m_latencySumMicros{0};
+        std::atomic<uint64_t> m_latencyMaxMicros{0};
+};
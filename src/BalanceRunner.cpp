@@ -0,0 +1,153 @@
+#include "BalanceRunner.h"
+#include "Aquarium.h"
+#include "Bots.h"
+#include "WorkerPool.h"
+#include <chrono>
+#include <iomanip>
+
+namespace {
+
+const int TankWidth = WorldWidth;
+const int TankHeight = WorldHeight;
+
+struct GameResult {
+    int finalScore = 0;
+    int framesPlayed = 0;
+    bool died = false;
+    std::vector<int> levelReachedFrame; // [n] = frame the n-th level started
+    std::vector<int> deathsPerLevel;    // lives lost while on the n-th level
+};
+
+// Everything a game touches is created here and owned by this call, random
+// engine included, so games on other workers never see each other.
+GameResult PlayGame(const LevelTable& levels, uint32_t seed, int maxFrames) {
+    auto aquarium = std::make_shared<Aquarium>(TankWidth, TankHeight, nullptr);
+    aquarium->seed(seed);
+    aquarium->setLevelTable(levels);
+    aquarium->getSpawnScheduler().SetBudget(0, 0); // no frame to protect, spawn everything at once
+    auto player = std::make_shared<PlayerCreature>(TankWidth / 2 - 50, TankHeight / 2 - 50, levels.playerSpeed, 0);
+    aquarium->Repopulate();
+
+    AquariumGameScene scene(player, aquarium, "balance");
+    ScriptedBot bot(seed * 2654435761u);
+    scene.SetController(&bot);
+
+    GameResult result;
+    result.levelReachedFrame.push_back(0);
+    result.deathsPerLevel.push_back(0);
+    int level = aquarium->getCurrentLevel();
+    int lives = player->getLives();
+
+    for (int frame = 1; frame <= maxFrames; ++frame) {
+        scene.Simulate();
+        result.framesPlayed = frame;
+
+        if (player->getLives() < lives) {
+            result.deathsPerLevel.back() += lives - player->getLives();
+            lives = player->getLives();
+        }
+        if (aquarium->getCurrentLevel() != level) {
+            level = aquarium->getCurrentLevel();
+            result.levelReachedFrame.push_back(frame);
+            result.deathsPerLevel.push_back(0);
+        }
+        if (scene.IsGameOver()) {
+            result.died = true;
+            break;
+        }
+    }
+
+    result.finalScore = player->getScore();
+    return result;
+}
+
+double Percentile(const std::vector<int>& sorted, double p) {
+    if (sorted.empty()) { return 0; }
+    return sorted[size_t(p * (sorted.size() - 1) + 0.5)];
+}
+
+void PrintReport(const std::vector<GameResult>& results, const BalanceOptions& options, unsigned threads, double seconds) {
+    size_t maxLevels = 0;
+    for (const GameResult& r : results) { maxLevels = std::max(maxLevels, r.levelReachedFrame.size()); }
+
+    std::cout << "== Balance report: " << results.size() << " games, " << threads << " threads, "
+              << std::fixed << std::setprecision(2) << seconds << " s ("
+              << results.size() / seconds << " games/s) ==" << std::endl;
+
+    std::cout << "level  games  time-to-level s (p50 / p90)  deaths/game  died here" << std::endl;
+    for (size_t l = 0; l < maxLevels; ++l) {
+        std::vector<int> reachFrames;
+        int deaths = 0, diedHere = 0, played = 0;
+        for (const GameResult& r : results) {
+            if (l >= r.levelReachedFrame.size()) { continue; }
+            ++played;
+            deaths += r.deathsPerLevel[l];
+            if (l + 1 == r.levelReachedFrame.size() && r.died) { ++diedHere; }
+            if (l > 0) { reachFrames.push_back(r.levelReachedFrame[l] - r.levelReachedFrame[l - 1]); }
+        }
+        std::sort(reachFrames.begin(), reachFrames.end());
+        std::cout << std::setw(5) << l << "  " << std::setw(5) << played << "  ";
+        if (l == 0) {
+            std::cout << std::setw(27) << "-";
+        } else {
+            std::cout << std::setw(12) << Percentile(reachFrames, 0.5) / 60.0 << " / " << std::setw(12) << Percentile(reachFrames, 0.9) / 60.0;
+        }
+        std::cout << "  " << std::setw(11) << double(deaths) / played << "  " << std::setw(9) << diedHere << std::endl;
+    }
+
+    std::vector<int> scores;
+    int died = 0;
+    for (const GameResult& r : results) {
+        scores.push_back(r.finalScore);
+        died += r.died ? 1 : 0;
+    }
+    std::sort(scores.begin(), scores.end());
+    std::cout << "scores: min " << scores.front() << "  p10 " << Percentile(scores, 0.1) << "  p50 " << Percentile(scores, 0.5)
+              << "  p90 " << Percentile(scores, 0.9) << "  max " << scores.back() << std::endl;
+    std::cout << "game over before " << options.maxFrames / 60 << " s: " << died << " / " << results.size() << std::endl;
+
+    // text histogram of final scores
+    const int buckets = 10;
+    int low = scores.front(), high = std::max(scores.back(), low + 1);
+    std::vector<int> histogram(buckets, 0);
+    for (int s : scores) { ++histogram[std::min(buckets - 1, (s - low) * buckets / (high - low))]; }
+    int tallest = *std::max_element(histogram.begin(), histogram.end());
+    for (int b = 0; b < buckets; ++b) {
+        int from = low + (high - low) * b / buckets;
+        std::cout << std::setw(6) << from << " | " << std::string(size_t(histogram[b] * 50 / std::max(1, tallest)), '#')
+                  << " " << histogram[b] << std::endl;
+    }
+}
+
+}
+
+int RunBalancing(const BalanceOptions& options) {
+    ofSetLogLevel(OF_LOG_WARNING); // the games log every life lost and level change
+    Profiler::SetEnabled(false); // scopes would have every thread hitting the same counters
+
+    LevelTable levels;
+    std::string error;
+    if (!LevelTable::LoadFromXml(ofToDataPath("settings.xml", true), levels, error)) {
+        std::cerr << "Using built-in levels: " << error << std::endl;
+        levels = LevelTable::Defaults();
+    }
+
+    WorkerPool pool(options.threads);
+    std::vector<GameResult> results(std::max(0, options.games));
+
+    auto start = std::chrono::steady_clock::now();
+    // one game per chunk; results land in their own slot, nothing is shared
+    pool.ParallelFor(results.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t g = begin; g < end; ++g) {
+            results[g] = PlayGame(levels, options.baseSeed + uint32_t(g), options.maxFrames);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (results.empty()) {
+        std::cerr << "No games to play" << std::endl;
+        return 1;
+    }
+    PrintReport(results, options, pool.GetThreadCount(), seconds);
+    return 0;
+}
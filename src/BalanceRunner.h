@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+struct BalanceOptions {
+    int games = 1000;
+    unsigned threads = 0;              // 0 = one per core
+    int maxFrames = 60 * 60 * 15;      // 15 minutes of game time per game
+    uint32_t baseSeed = 1;             // game i plays with seed baseSeed + i
+};
+
+// Plays many complete headless games with scripted bots, spread across all
+// cores, and prints time-to-level, deaths per level and score distribution.
+// Run with `./bin/Aquarium --balance [games] [threads]`.
+int RunBalancing(const BalanceOptions& options);
@@ -0,0 +1,545 @@
+#include "Benchmarks.h"
+#include "Aquarium.h"
+#include "AquariumManager.h"
+#include "Bots.h"
+#include "CreatureRecords.h"
+#include "FixedSimulation.h"
+#include "MemoryReport.h"
+#include "ParticleSystem.h"
+#include "PredatorChain.h"
+#include "Schooling.h"
+#include "WorkerPool.h"
+#include "ofMain.h"
+#include <chrono>
+#include <random>
+
+namespace {
+
+using BenchClock = std::chrono::steady_clock;
+
+double ElapsedMicros(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::micro>(BenchClock::now() - start).count();
+}
+
+}
+
+int RunBenchmarks(const std::string& name) {
+    bool all = name.empty() || name == "all";
+    bool ran = false;
+    if (all || name == "chains") { BenchmarkPredatorChains(); ran = true; }
+    if (all || name == "schooling") { BenchmarkSchooling(); ran = true; }
+    if (all || name == "particles") { BenchmarkParticles(); ran = true; }
+    if (all || name == "memory") { BenchmarkCreatureMemory(); ran = true; }
+    if (all || name == "tanks") { BenchmarkTanks(); ran = true; }
+    if (all || name == "animation") { BenchmarkAnimation(); ran = true; }
+    if (all || name == "fixed") { BenchmarkFixedPoint(); ran = true; }
+    if (all || name == "collisions") { BenchmarkPredatorCollisions(); ran = true; }
+
+    if (!ran) {
+        std::cerr << "Unknown benchmark: " << name << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 100 predators of 50 segments each, heads circling so every segment moves
+// every tick. The per-predator ofVec2f loop we used to run is kept here as a
+// baseline so the pool numbers have something to be compared against.
+void BenchmarkPredatorChains() {
+    const int predators = 100;
+    const int segments = 50;
+    const int ticks = 2000;
+    const float spacing = 40.0f;
+
+    PredatorChainPool pool;
+    std::vector<PredatorChainPool::ChainId> ids;
+    for (int p = 0; p < predators; ++p) {
+        ids.push_back(pool.Allocate(segments, p * 10.0f, p * 5.0f, spacing));
+    }
+
+    auto start = BenchClock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (int p = 0; p < predators; ++p) {
+            float angle = (t + p) * 0.05f;
+            pool.SetHead(ids[p], 500 + std::cos(angle) * 300, 400 + std::sin(angle) * 300);
+        }
+        pool.Solve();
+    }
+    double poolMicros = ElapsedMicros(start);
+
+    std::vector<std::vector<ofVec2f>> legacy(predators, std::vector<ofVec2f>(segments));
+    for (int p = 0; p < predators; ++p) {
+        for (int i = 0; i < segments; ++i) {
+            legacy[p][i].set(p * 10.0f - i * spacing, p * 5.0f);
+        }
+    }
+
+    start = BenchClock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (int p = 0; p < predators; ++p) {
+            float angle = (t + p) * 0.05f;
+            std::vector<ofVec2f>& chain = legacy[p];
+            chain[0].set(500 + std::cos(angle) * 300, 400 + std::sin(angle) * 300);
+            for (size_t i = 1; i < chain.size(); ++i) {
+                ofVec2f delta = chain[i - 1] - chain[i];
+                float dist = delta.length();
+                if (dist > 0.0001f) {
+                    delta.normalize();
+                    chain[i] += delta * (dist - spacing);
+                }
+            }
+        }
+    }
+    double legacyMicros = ElapsedMicros(start);
+
+    // checksum keeps the optimizer from throwing the work away
+    float checksum = 0.0f;
+    for (int p = 0; p < predators; ++p) {
+        ChainView view = pool.GetChain(ids[p]);
+        checksum += view.x(view.size() - 1) - legacy[p].back().x;
+    }
+
+    std::cout << "[chains] " << predators << " predators x " << segments << " segments, " << ticks << " ticks" << std::endl;
+    std::cout << "  pool solver   : " << poolMicros / ticks << " us/tick" << std::endl;
+    std::cout << "  legacy ofVec2f: " << legacyMicros / ticks << " us/tick" << std::endl;
+    std::cout << "  drift vs legacy: " << checksum << std::endl;
+}
+
+// 5,000 schooling fish in a 1024x768 tank with the player and a few
+// predators to flee from. Each tick rebuilds the grid, solves headings and
+// integrates positions, which is everything Aquarium::update adds for them.
+void BenchmarkSchooling() {
+    const int fishCount = 5000;
+    const int ticks = 300;
+    const float width = 1024, height = 768;
+    const double frameBudgetMs = 1000.0 / 60.0;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> px(0, width), py(0, height), dir(-1, 1);
+    std::vector<float> xs(fishCount), ys(fishCount), dxs(fishCount), dys(fishCount);
+    for (int i = 0; i < fishCount; ++i) {
+        xs[i] = px(rng); ys[i] = py(rng);
+        dxs[i] = dir(rng); dys[i] = dir(rng);
+    }
+
+    auto runTicks = [&](WorkerPool* pool) {
+        std::vector<float> x = xs, y = ys, dx = dxs, dy = dys;
+        SchoolingSystem school;
+        auto start = BenchClock::now();
+        for (int t = 0; t < ticks; ++t) {
+            school.Clear();
+            for (int i = 0; i < fishCount; ++i) {
+                school.AddFish(x[i], y[i], dx[i], dy[i]);
+            }
+            school.AddThreat(width / 2 + std::cos(t * 0.02f) * 200, height / 2);
+            for (int p = 0; p < 4; ++p) {
+                school.AddThreat(p * 250.0f, height / 3);
+            }
+            school.Solve(width, height, pool);
+            for (int i = 0; i < fishCount; ++i) {
+                dx[i] = school.GetHeadingX(i);
+                dy[i] = school.GetHeadingY(i);
+                x[i] += dx[i] * 3;
+                y[i] += dy[i] * 3;
+                if (x[i] < 0 || x[i] > width) { dx[i] = -dx[i]; x[i] = std::min(std::max(x[i], 0.0f), width); }
+                if (y[i] < 0 || y[i] > height) { dy[i] = -dy[i]; y[i] = std::min(std::max(y[i], 0.0f), height); }
+            }
+        }
+        return ElapsedMicros(start) / 1000.0 / ticks;
+    };
+
+    double serialMs = runTicks(nullptr);
+    double parallelMs = runTicks(&WorkerPool::Shared());
+
+    std::cout << "[schooling] " << fishCount << " fish, " << ticks << " ticks, max "
+              << SchoolingParams().maxNeighbors << " neighbors per fish" << std::endl;
+    std::cout << "  serial  : " << serialMs << " ms/tick (" << serialMs / frameBudgetMs * 100 << "% of a 60 FPS frame)" << std::endl;
+    std::cout << "  parallel: " << parallelMs << " ms/tick (" << parallelMs / frameBudgetMs * 100 << "% of a 60 FPS frame, "
+              << WorkerPool::Shared().GetThreadCount() << " threads)" << std::endl;
+}
+
+// Keeps 50,000+ particles alive (eat bursts all over the tank plus ambient
+// bubbles) and times the simulation step and the vertex preparation that
+// Draw() does before the upload. The GL upload itself needs a window and is
+// not part of this.
+void BenchmarkParticles() {
+    const int ticks = 600;
+    const float dt = 1.0f / 60.0f;
+    const double frameBudgetMs = 1000.0 / 60.0;
+
+    ParticleSystem particles;
+    particles.bubblesPerSecond = 2000.0f;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> px(0, 1024), py(0, 768);
+
+    // warm up until the population is steady
+    for (int t = 0; t < 120; ++t) {
+        for (int b = 0; b < 20; ++b) { particles.Emit(ParticleEffect::PowerUp, px(rng), py(rng)); }
+        particles.EmitAmbient(dt, 1024, 768);
+        particles.Update(dt);
+    }
+
+    double updateMicros = 0, prepareMicros = 0;
+    size_t minAlive = particles.GetCount(), maxAlive = 0;
+    for (int t = 0; t < ticks; ++t) {
+        for (int b = 0; b < 20; ++b) { particles.Emit(ParticleEffect::PowerUp, px(rng), py(rng)); }
+        particles.EmitAmbient(dt, 1024, 768);
+
+        auto start = BenchClock::now();
+        particles.Update(dt);
+        updateMicros += ElapsedMicros(start);
+
+        start = BenchClock::now();
+        particles.PrepareVertices();
+        prepareMicros += ElapsedMicros(start);
+
+        minAlive = std::min(minAlive, particles.GetCount());
+        maxAlive = std::max(maxAlive, particles.GetCount());
+    }
+
+    double totalMs = (updateMicros + prepareMicros) / 1000.0 / ticks;
+    std::cout << "[particles] " << minAlive << " - " << maxAlive << " live particles, " << ticks << " ticks" << std::endl;
+    std::cout << "  update : " << updateMicros / ticks << " us/tick" << std::endl;
+    std::cout << "  prepare: " << prepareMicros / ticks << " us/tick" << std::endl;
+    std::cout << "  total  : " << totalMs << " ms/tick (" << totalMs / frameBudgetMs * 100 << "% of a 60 FPS frame)" << std::endl;
+}
+
+// Memory report of a headless aquarium ten seconds in, then a million
+// fish and crabs stepped as live creature objects and as compact records.
+// Both use the same movement code path, the drift line should read 0.
+void BenchmarkCreatureMemory() {
+    {
+        auto aquarium = std::make_shared<Aquarium>(WorldWidth, WorldHeight, nullptr);
+        aquarium->seed(3);
+        aquarium->setLevelTable(LevelTable::Defaults());
+        aquarium->getSpawnScheduler().SetBudget(0, 0);
+        aquarium->Repopulate();
+        auto player = std::make_shared<PlayerCreature>(WorldWidth / 2 - 50, WorldHeight / 2 - 50, 5, 0);
+        AquariumGameScene scene(player, aquarium, "memory");
+        for (int t = 0; t < 600 && !scene.IsGameOver(); ++t) { scene.Simulate(); }
+        AquariumMemory::Print(AquariumMemory::Measure(*aquarium), std::cout);
+    }
+
+    const int count = 1000000;
+    const int ticks = 60;
+    const AquariumCreatureType types[] = {AquariumCreatureType::NPCreature, AquariumCreatureType::BiggerFish,
+                                          AquariumCreatureType::Crab};
+
+    GameRng rng(11);
+    std::vector<std::shared_ptr<Creature>> live;
+    live.reserve(count);
+    CreatureRecords records;
+    records.Reserve(count);
+    for (int i = 0; i < count; ++i) {
+        AquariumCreatureType type = types[i % 3];
+        float x = GameRandom::Range(rng, 0.0f, float(WorldWidth));
+        float y = GameRandom::Range(rng, 0.0f, float(WorldHeight));
+        int speed = 1 + GameRandom::Below(rng, 4);
+        std::shared_ptr<Creature> creature;
+        switch (type) {
+            case AquariumCreatureType::NPCreature: creature = std::make_shared<BaseFish>(x, y, WorldHeight, speed, 0, rng); break;
+            case AquariumCreatureType::BiggerFish: creature = std::make_shared<BiggerFish>(x, y, WorldHeight, speed, 0, rng); break;
+            default: creature = std::make_shared<Crab>(x, y, WorldHeight, speed, 0, rng); break;
+        }
+        records.Add(type, creature->getX(), creature->getY(), creature->getDx(), creature->getDy(), speed);
+        live.push_back(std::move(creature));
+    }
+
+    WorldContext world;
+    auto start = BenchClock::now();
+    for (int t = 0; t < ticks; ++t) {
+        for (auto& creature : live) { creature->move(world); }
+    }
+    double liveMs = ElapsedMicros(start) / 1000.0 / ticks;
+
+    start = BenchClock::now();
+    for (int t = 0; t < ticks; ++t) {
+        records.Step(world.width, world.height);
+    }
+    double recordMs = ElapsedMicros(start) / 1000.0 / ticks;
+
+    float drift = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        drift += std::abs(live[i]->getX() - records[i].x) + std::abs(live[i]->getY() - records[i].y);
+    }
+
+    const double mb = 1024.0 * 1024.0;
+    size_t liveBytes = live.capacity() * sizeof(std::shared_ptr<Creature>) +
+                       count * (AquariumMemory::ObjectSize(AquariumCreatureType::NPCreature) + AquariumMemory::ControlBlockBytes);
+    std::cout << "[memory] " << count << " fish and crabs, " << ticks << " ticks" << std::endl;
+    std::cout << "  live objects : " << liveBytes / mb << " MB (" << double(liveBytes) / count << " B each), " << liveMs << " ms/tick" << std::endl;
+    std::cout << "  records      : " << records.GetBytes() / mb << " MB (" << sizeof(CreatureRecord) << " B each), " << recordMs << " ms/tick" << std::endl;
+    std::cout << "  drift vs live: " << drift << std::endl;
+}
+
+// 32 headless tanks with avoidance bots, ticked together on schedulers of
+// 1, 2, 4... threads up to the core count. Every thread count replays the
+// same games, so the tanks do the same work and only the spread changes.
+void BenchmarkTanks() {
+    const int tanks = 32;
+    const int ticks = 600;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    ofSetLogLevel(OF_LOG_WARNING);
+    Profiler::SetEnabled(false);
+
+    std::cout << "[tanks] " << tanks << " tanks, " << ticks << " ticks" << std::endl;
+    double serialMs = 0.0;
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, cores)) {
+        TaskScheduler scheduler(threads);
+        AquariumManager manager(scheduler);
+        manager.SetRestartOnGameOver(true);
+        for (int i = 0; i < tanks; ++i) {
+            manager.AddTank(LevelTable::Defaults(), uint32_t(i + 1), MakeBot("avoid", uint32_t(i + 1)));
+        }
+
+        double stepMs = 0.0, worst = 0.0;
+        for (int t = 0; t < ticks; ++t) {
+            manager.Step();
+            stepMs += manager.GetLastStepMs();
+        }
+        double tankMs = 0.0;
+        for (size_t i = 0; i < manager.GetTankCount(); ++i) {
+            tankMs += manager.GetTiming(i).avgMs;
+            worst = std::max(worst, manager.GetTiming(i).maxMs);
+        }
+        stepMs /= ticks;
+        if (threads == 1) { serialMs = stepMs; }
+        std::cout << "  " << threads << " threads: step " << stepMs << " ms, tanks add up to " << tankMs << " ms, slowest tick "
+                  << worst << " ms, speedup " << serialMs / stepMs << "x, " << scheduler.GetStealCount() << " steals" << std::endl;
+        if (threads == cores) { break; }
+    }
+}
+
+// 10000 fish a frame through the animation batch, once all on a static
+// single frame and once on an 8 frame swim cycle with scattered start
+// ticks. Frame selection is the shader's job, so the CPU side (filling the
+// vertex arrays) should cost the same for both.
+void BenchmarkAnimation() {
+    const int fish = 10000;
+    const int frames = 600;
+
+    SpriteSheet sheet;
+    sheet.image = "bench-sheet.png";
+    sheet.columns = 8;
+    sheet.width = 70;
+    sheet.height = 70;
+    uint16_t sheetIndex = AnimationTable::AddSheet(sheet);
+    AnimationDef still;
+    still.name = "bench-still";
+    still.sheet = sheetIndex;
+    AnimationDef swim = still;
+    swim.name = "bench-swim";
+    swim.frameCount = 8;
+    swim.fps = 12.0f;
+    AnimationId stillId = AnimationTable::Add(still);
+    AnimationId swimId = AnimationTable::Add(swim);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> px(0, 1024), py(0, 768);
+    std::vector<CreatureRecord> school(fish);
+    for (CreatureRecord& record : school) {
+        record.x = px(rng);
+        record.y = py(rng);
+        record.animationStart = uint16_t(rng());
+        record.flags = rng() % 2 ? CreatureRecord::Flipped : 0;
+    }
+
+    AnimationBatch batch;
+    auto run = [&](AnimationId animation) {
+        auto start = BenchClock::now();
+        for (int f = 0; f < frames; ++f) {
+            batch.Begin(uint64_t(f));
+            for (const CreatureRecord& record : school) {
+                batch.Add(animation, record.animationStart, record.x, record.y, record.flags & CreatureRecord::Flipped);
+            }
+        }
+        return ElapsedMicros(start) / frames;
+    };
+    run(swimId); // warm up, the arrays grow once
+    double stillMicros = run(stillId);
+    double swimMicros = run(swimId);
+
+    std::cout << "[animation] " << fish << " fish, " << frames << " frames, vertex arrays only (no GL)" << std::endl;
+    std::cout << "  static  : " << stillMicros << " us/frame" << std::endl;
+    std::cout << "  animated: " << swimMicros << " us/frame (" << swimMicros / stillMicros << "x static)" << std::endl;
+    std::cout << "  swim frame 1s in: " << AnimationTable::FrameAt(*AnimationTable::Get(swimId), 60) << " (12 fps over frames 0-7)" << std::endl;
+}
+
+// The same tank stepped through the float path (CreatureRecords, the
+// chain pool and the collision rules) and through FixedSimulation: 2000
+// fish and crabs, 20 baby predators, the player circling. The fixed run is
+// done twice and its hash compared with the one every build should get.
+void BenchmarkFixedPoint() {
+    const int fish = 2000;
+    const int predators = 20;
+    const int ticks = 2000;
+    // FixedSimulation::Hash() after the run below, on any machine
+    const uint64_t referenceHash = 0xdd8d4bc9a0b4a949ull;
+
+    struct Spawn { AquariumCreatureType type; int x, y, dx, dy, speed; };
+    std::vector<Spawn> spawns;
+    // GameRandom maps mt19937's output itself, so with the draws in a fixed
+    // order (named locals, never two in one argument list) the setup is
+    // the same everywhere. Braced lists are evaluated left to right.
+    GameRng rng(21);
+    const AquariumCreatureType kinds[] = {AquariumCreatureType::NPCreature, AquariumCreatureType::BiggerFish, AquariumCreatureType::Crab};
+    for (int i = 0; i < fish; ++i) {
+        Spawn spawn{kinds[GameRandom::Below(rng, 3)], GameRandom::Below(rng, 1000), GameRandom::Below(rng, 700),
+                    GameRandom::Below(rng, 3) - 1, GameRandom::Below(rng, 3) - 1, 1 + GameRandom::Below(rng, 25)};
+        if (spawn.dx == 0 && spawn.dy == 0) { spawn.dx = 1; }
+        spawns.push_back(spawn);
+    }
+    std::vector<std::pair<int, int>> heads;
+    for (int p = 0; p < predators; ++p) {
+        int x = GameRandom::Below(rng, 1000);
+        int y = GameRandom::Below(rng, 700);
+        heads.emplace_back(x, y);
+    }
+    const AquariumCreatureType predatorType = AquariumCreatureType::BabyPredator;
+    const int predatorSpeed = 10;
+
+    // float path
+    CreatureRecords records;
+    for (const Spawn& spawn : spawns) {
+        float length = std::sqrt(float(spawn.dx * spawn.dx + spawn.dy * spawn.dy));
+        records.Add(spawn.type, float(spawn.x), float(spawn.y), spawn.dx / length, spawn.dy / length, spawn.speed);
+    }
+    PredatorChainPool pool;
+    std::vector<PredatorChainPool::ChainId> chains;
+    for (const auto& head : heads) {
+        chains.push_back(pool.Allocate(GetArchetype(predatorType).bodySegments + 2, float(head.first), float(head.second), Predator::SegmentSpacing));
+    }
+    float px = WorldWidth / 2.0f, py = WorldHeight / 2.0f;
+    int floatHits = 0;
+    auto start = BenchClock::now();
+    for (int t = 1; t <= ticks; ++t) {
+        px += std::cos(t / 60.0f) * 5.0f;
+        py += std::sin(t / 60.0f) * 5.0f;
+        float wobble = std::sin(t / 60.0f * 4.0f) * 0.5f;
+        float c = std::cos(wobble), s = std::sin(wobble);
+        for (PredatorChainPool::ChainId id : chains) {
+            ChainView chain = pool.GetChain(id);
+            float dx = px - chain.x(0), dy = py - chain.y(0);
+            float length = std::sqrt(dx * dx + dy * dy);
+            if (length > 0.0001f) { dx /= length; dy /= length; }
+            pool.SetHead(id, chain.x(0) + (dx * c - dy * s) * predatorSpeed * 2, chain.y(0) + (dx * s + dy * c) * predatorSpeed * 2);
+        }
+        records.Step(WorldWidth, WorldHeight);
+        pool.Solve();
+        bool hit = false;
+        for (size_t i = 0; i < records.size() && !hit; ++i) {
+            float dx = px - records[i].x, dy = py - records[i].y;
+            float r = PlayerCreature::CollisionRadius - GetArchetype(AquariumCreatureType(records[i].type)).collisionRadius;
+            hit = dx * dx + dy * dy <= r * r;
+        }
+        for (size_t p = 0; p < chains.size() && !hit; ++p) {
+            ChainView chain = pool.GetChain(chains[p]);
+            for (size_t i = 0; i < chain.size() && !hit; ++i) {
+                float dx = chain.x(i) - px, dy = chain.y(i) - py;
+                float r = i == 0 ? Predator::HeadHitRadius : i + 1 == chain.size() ? Predator::TailHitRadius : Predator::BodyHitRadius;
+                hit = dx * dx + dy * dy < r * r;
+            }
+        }
+        floatHits += hit;
+    }
+    double floatMicros = ElapsedMicros(start) / ticks;
+
+    // fixed path, twice
+    auto runFixed = [&](int& hits) {
+        FixedSimulation sim;
+        sim.SetPlayer(FixedSimulation::Vec{Fixed::FromInt(WorldWidth / 2), Fixed::FromInt(WorldHeight / 2)}, 5,
+                      Fixed::FromInt(int(PlayerCreature::CollisionRadius)));
+        for (const Spawn& spawn : spawns) {
+            FixedSimulation::Vec direction{Fixed::FromInt(spawn.dx), Fixed::FromInt(spawn.dy)};
+            FixedMath::Normalize(direction.x, direction.y);
+            sim.AddCreature(spawn.type, FixedSimulation::Vec{Fixed::FromInt(spawn.x), Fixed::FromInt(spawn.y)}, direction, spawn.speed);
+        }
+        for (const auto& head : heads) {
+            sim.AddPredator(predatorType, FixedSimulation::Vec{Fixed::FromInt(head.first), Fixed::FromInt(head.second)}, predatorSpeed);
+        }
+        hits = 0;
+        auto begin = BenchClock::now();
+        for (int t = 1; t <= ticks; ++t) {
+            Fixed angle = FixedMath::TickAngle(uint64_t(t), Fixed::FromInt(1));
+            sim.Step(FixedSimulation::Vec{FixedMath::Cos(angle), FixedMath::Sin(angle)});
+            hits += sim.GetLastHit() >= 0;
+        }
+        return std::make_pair(ElapsedMicros(begin) / ticks, sim.Hash());
+    };
+    int fixedHits = 0, againHits = 0;
+    auto fixedRun = runFixed(fixedHits);
+    auto againRun = runFixed(againHits);
+
+    char hash[32];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)fixedRun.second);
+    std::cout << "[fixed point] " << fish << " fish and crabs, " << predators << " predators, " << ticks << " ticks" << std::endl;
+    std::cout << "  float  : " << floatMicros << " us/tick, " << floatHits << " ticks with a hit" << std::endl;
+    std::cout << "  Q16.16 : " << fixedRun.first << " us/tick (" << fixedRun.first / floatMicros << "x float), " << fixedHits
+              << " ticks with a hit" << std::endl;
+    std::cout << "  state hash " << hash << ", second run " << (againRun.second == fixedRun.second ? "identical" : "DIFFERENT")
+              << ", reference " << (fixedRun.second == referenceHash ? "matches" : "MISMATCH") << std::endl;
+}
+
+// 40 predators (half of them babies) chasing a player that runs a loop faster than they
+// can swim, so most of them trail behind. Every tick the
+// chains move and solve like in Aquarium::update, then the player is tested
+// with DetectAquariumCollisions (bounds first) and with the old loop over
+// every segment, kept here as the baseline. Both have to agree.
+void BenchmarkPredatorCollisions() {
+    const int predators = 40;
+    const int ticks = 2000;
+
+    Aquarium aquarium(WorldWidth, WorldHeight, nullptr);
+    aquarium.seed(5);
+    aquarium.setLevelTable(LevelTable::Defaults());
+    for (int p = 0; p < predators; ++p) {
+        aquarium.SpawnCreature(p % 2 ? AquariumCreatureType::Predator : AquariumCreatureType::BabyPredator);
+    }
+    PlayerCreature player(WorldWidth / 2.0f, WorldHeight / 2.0f, 5, 0);
+
+    WorldContext world;
+    double boundsMicros = 0.0, legacyMicros = 0.0;
+    int hits = 0, mismatches = 0;
+    for (int t = 1; t <= ticks; ++t) {
+        world.tick = uint64_t(t);
+        world.time = t / 60.0f;
+        player.setState(CreatureState{WorldWidth / 2.0f + std::cos(t / 12.0f) * 400.0f,
+                                      WorldHeight / 2.0f + std::sin(t / 17.0f) * 300.0f, 0, 0, 5});
+        world.player = player.snapshot();
+        aquarium.gatherSchooling(world);
+        aquarium.moveCreatures(world, MoveGroup::Predators);
+        aquarium.solveChains();
+
+        auto start = BenchClock::now();
+        GameEvent event = DetectAquariumCollisions(aquarium, player);
+        boundsMicros += ElapsedMicros(start);
+
+        start = BenchClock::now();
+        Creature* legacyHit = nullptr;
+        for (int i = 0; i < aquarium.getCreatureCount() && !legacyHit; ++i) {
+            // same casts as the real thing so only the segment tests differ
+            Creature* creature = aquarium.getCreatures()[size_t(i)].get();
+            if (dynamic_cast<SpeedPowerUp*>(creature)) { continue; }
+            auto predator = dynamic_cast<Predator*>(creature);
+            if (!predator) { continue; }
+            ChainView segments = predator->getSegments();
+            for (size_t s = 0; s < segments.size(); ++s) {
+                float dx = segments.x(s) - player.getX(), dy = segments.y(s) - player.getY();
+                float r = s == 0 ? Predator::HeadHitRadius : s + 1 == segments.size() ? Predator::TailHitRadius : Predator::BodyHitRadius;
+                if (dx * dx + dy * dy < r * r) { legacyHit = predator; break; }
+            }
+        }
+        legacyMicros += ElapsedMicros(start);
+
+        Creature* boundsHit = event.isCollisionEvent() ? aquarium.resolve(event.creatureB) : nullptr;
+        hits += boundsHit != nullptr;
+        mismatches += boundsHit != legacyHit;
+    }
+
+    const PredatorCullStats& cull = aquarium.getPredatorCullStats();
+    std::cout << "[collisions] " << predators << " predators, " << ticks << " ticks" << std::endl;
+    std::cout << "  bounds first : " << boundsMicros / ticks << " us/tick, " << cull.CullRate() * 100 << "% of predators culled, "
+              << cull.FalsePositiveRate() * 100 << "% of the rest missed anyway" << std::endl;
+    std::cout << "  every segment: " << legacyMicros / ticks << " us/tick" << std::endl;
+    std::cout << "  " << hits << " ticks with a hit, " << mismatches << " disagreements" << std::endl;
+}
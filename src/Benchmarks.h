@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+// Headless micro benchmarks. They never open a window or touch GL, run them
+// with `./bin/Aquarium --bench [name]` (no name runs all of them).
+int RunBenchmarks(const std::string& name);
+
+void BenchmarkPredatorChains();
+void BenchmarkSchooling();
+void BenchmarkParticles();
+void BenchmarkCreatureMemory();
+void BenchmarkTanks();
+void BenchmarkAnimation();
+void BenchmarkFixedPoint();
+void BenchmarkPredatorCollisions();
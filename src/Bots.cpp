@@ -0,0 +1,181 @@
+#include "Bots.h"
+#include "Aquarium.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// -1, 0 or 1, with a dead zone so near-vertical moves don't jitter sideways
+float SnapAxis(float v) {
+    if (v > 0.35f) { return 1.0f; }
+    if (v < -0.35f) { return -1.0f; }
+    return 0.0f;
+}
+
+// Distance from the player to the closest part of a creature, which for
+// predators means any segment of the body.
+float DistanceSqTo(const Creature& creature, float px, float py, float& tx, float& ty) {
+    tx = creature.getX();
+    ty = creature.getY();
+    float best = (tx - px) * (tx - px) + (ty - py) * (ty - py);
+    if (auto predator = dynamic_cast<const Predator*>(&creature)) {
+        ChainView segments = predator->getSegments();
+        for (size_t s = 0; s < segments.size(); ++s) {
+            float dx = segments.x(s) - px;
+            float dy = segments.y(s) - py;
+            if (dx * dx + dy * dy < best) {
+                best = dx * dx + dy * dy;
+                tx = segments.x(s);
+                ty = segments.y(s);
+            }
+        }
+    }
+    return best;
+}
+
+// Unit vector towards (dx, dy), or zero.
+void Normalize(float& dx, float& dy) {
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len > 0.0001f) {
+        dx /= len;
+        dy /= len;
+    } else {
+        dx = dy = 0.0f;
+    }
+}
+
+}
+
+ScriptedBot::ScriptedBot(uint32_t seed) : m_rng(seed) {
+    // bots differ in how jumpy they are
+    m_fleeRadius = GameRandom::Range(m_rng, 120.0f, 220.0f);
+}
+
+void ScriptedBot::Drive(PlayerCreature& player, const Aquarium& aquarium) {
+    if (m_framesUntilPlan-- <= 0) {
+        this->plan(player, aquarium);
+        // human-ish reaction time, 50 to 150 ms at 60 FPS
+        m_framesUntilPlan = 3 + GameRandom::Below(m_rng, 7);
+    }
+    player.setDirection(m_dx, m_dy);
+}
+
+void ScriptedBot::plan(const PlayerCreature& player, const Aquarium& aquarium) {
+    const float px = player.getX();
+    const float py = player.getY();
+
+    float threatDist = std::numeric_limits<float>::max(), threatX = 0, threatY = 0;
+    float foodDist = std::numeric_limits<float>::max(), foodX = 0, foodY = 0;
+
+    for (const auto& creature : aquarium.getCreatures()) {
+        float tx, ty;
+        float distSq = DistanceSqTo(*creature, px, py, tx, ty);
+        // same rule as AquariumGameScene: eating needs power >= value
+        bool edible = player.getPower() >= creature->getValue();
+        if (edible && distSq < foodDist) {
+            foodDist = distSq; foodX = tx; foodY = ty;
+        } else if (!edible && distSq < threatDist) {
+            threatDist = distSq; threatX = tx; threatY = ty;
+        }
+    }
+
+    float dx, dy;
+    if (threatDist < m_fleeRadius * m_fleeRadius) {
+        dx = px - threatX;
+        dy = py - threatY;
+    } else if (foodDist < std::numeric_limits<float>::max()) {
+        dx = foodX - px;
+        dy = foodY - py;
+    } else {
+        dx = GameRandom::Range(m_rng, -1.0f, 1.0f);
+        dy = GameRandom::Range(m_rng, -1.0f, 1.0f);
+    }
+
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len > 0.0001f) {
+        dx /= len;
+        dy /= len;
+    }
+    m_dx = SnapAxis(dx);
+    m_dy = SnapAxis(dy);
+}
+
+void RandomWalkBot::Drive(PlayerCreature& player, const Aquarium& /*aquarium*/) {
+    if (m_framesLeft-- <= 0) {
+        if (GameRandom::Below(m_rng, 6) == 0) {
+            m_dx = m_dy = 0.0f; // take a break now and then
+        } else {
+            float angle = GameRandom::Range(m_rng, 0.0f, 6.2831853f);
+            m_dx = std::cos(angle);
+            m_dy = std::sin(angle);
+        }
+        m_framesLeft = 30 + GameRandom::Below(m_rng, 61);
+    }
+    player.setDirection(m_dx, m_dy);
+}
+
+void GreedyBot::Drive(PlayerCreature& player, const Aquarium& aquarium) {
+    const float px = player.getX();
+    const float py = player.getY();
+    float bestDist = std::numeric_limits<float>::max(), bestX = 0, bestY = 0;
+    for (const auto& creature : aquarium.getCreatures()) {
+        if (player.getPower() < creature->getValue()) { continue; } // same rule as the collision code
+        float dx = creature->getX() - px;
+        float dy = creature->getY() - py;
+        if (dx * dx + dy * dy < bestDist) {
+            bestDist = dx * dx + dy * dy;
+            bestX = creature->getX();
+            bestY = creature->getY();
+        }
+    }
+    if (bestDist < std::numeric_limits<float>::max()) {
+        m_dx = bestX - px;
+        m_dy = bestY - py;
+        Normalize(m_dx, m_dy);
+    } else if (GameRandom::Below(m_rng, 61) == 0) {
+        // nothing to eat yet, keep drifting and turn once in a while
+        float angle = GameRandom::Range(m_rng, 0.0f, 6.2831853f);
+        m_dx = std::cos(angle);
+        m_dy = std::sin(angle);
+    }
+    player.setDirection(m_dx, m_dy);
+}
+
+void AvoidanceBot::Drive(PlayerCreature& player, const Aquarium& aquarium) {
+    const float px = player.getX();
+    const float py = player.getY();
+    const float radiusSq = avoidRadius * avoidRadius;
+    float awayX = 0.0f, awayY = 0.0f;
+    for (const auto& creature : aquarium.getCreatures()) {
+        auto predator = dynamic_cast<const Predator*>(creature.get());
+        if (!predator) { continue; }
+        ChainView segments = predator->getSegments();
+        for (size_t s = 0; s < segments.size(); ++s) {
+            float dx = px - segments.x(s);
+            float dy = py - segments.y(s);
+            float distSq = dx * dx + dy * dy;
+            if (distSq < radiusSq && distSq > 0.0001f) {
+                awayX += dx / distSq; // 1/d falloff once normalized
+                awayY += dy / distSq;
+            }
+        }
+    }
+    if (awayX == 0.0f && awayY == 0.0f) {
+        m_greedy.Drive(player, aquarium);
+        return;
+    }
+    Normalize(awayX, awayY);
+    player.setDirection(awayX, awayY);
+}
+
+std::unique_ptr<PlayerController> MakeBot(const std::string& name, uint32_t seed) {
+    if (name == "scripted") { return std::make_unique<ScriptedBot>(seed); }
+    if (name == "random") { return std::make_unique<RandomWalkBot>(seed); }
+    if (name == "greedy") { return std::make_unique<GreedyBot>(seed); }
+    if (name == "avoid") { return std::make_unique<AvoidanceBot>(seed); }
+    return nullptr;
+}
+
+const char* BotNames() {
+    return "scripted, random, greedy, avoid";
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "GameRandom.h"
+#include <string>
+#include "PlayerController.h"
+
+// Scripted stand-in for a human player. It re-plans every few frames like a
+// person reacting to the screen: run from the closest creature it can't eat,
+// otherwise chase the closest one it can, otherwise wander. Directions are
+// snapped to the 8 a keyboard can produce.
+class ScriptedBot : public PlayerController {
+    public:
+        explicit ScriptedBot(uint32_t seed);
+        const char* GetName() const override { return "scripted"; }
+        void Drive(PlayerCreature& player, const Aquarium& aquarium) override;
+
+    private:
+        void plan(const PlayerCreature& player, const Aquarium& aquarium);
+
+        GameRng m_rng;
+        float m_dx = 0.0f;
+        float m_dy = 0.0f;
+        int m_framesUntilPlan = 0;
+        float m_fleeRadius = 160.0f;
+};
+
+// Picks a random heading every second or so, sometimes stands still.
+// Cheapest possible player, good for loading the simulation itself.
+class RandomWalkBot : public PlayerController {
+    public:
+        explicit RandomWalkBot(uint32_t seed) : m_rng(seed) {}
+        const char* GetName() const override { return "random"; }
+        void Drive(PlayerCreature& player, const Aquarium& aquarium) override;
+
+    private:
+        GameRng m_rng;
+        float m_dx = 0.0f;
+        float m_dy = 0.0f;
+        int m_framesLeft = 0;
+};
+
+// Heads for the nearest creature it has the power to eat and ignores
+// everything else, so it gets hurt a lot and the levels keep turning over.
+class GreedyBot : public PlayerController {
+    public:
+        explicit GreedyBot(uint32_t seed) : m_rng(seed) {}
+        const char* GetName() const override { return "greedy"; }
+        void Drive(PlayerCreature& player, const Aquarium& aquarium) override;
+
+    private:
+        GameRng m_rng;
+        float m_dx = 1.0f;
+        float m_dy = 0.0f;
+};
+
+// Steers away from every predator body segment within its radius, weighted
+// by how close each one is; with nothing around it eats like GreedyBot.
+// Long lived, so it is the one to use for soak runs.
+class AvoidanceBot : public PlayerController {
+    public:
+        explicit AvoidanceBot(uint32_t seed) : m_greedy(seed) {}
+        const char* GetName() const override { return "avoid"; }
+        void Drive(PlayerCreature& player, const Aquarium& aquarium) override;
+
+        float avoidRadius = 220.0f;
+
+    private:
+        GreedyBot m_greedy;
+};
+
+// "scripted", "random", "greedy" or "avoid"; null for anything else.
+std::unique_ptr<PlayerController> MakeBot(const std::string& name, uint32_t seed);
+const char* BotNames();
@@ -1,41 +1,54 @@
 #include "Core.h"
+#include "GameEventBus.h"
 
-std::weak_ptr<PlayerCreature> Creature::s_player;
+namespace {
 
-// Creature Inherited Base Behavior
-void Creature::setBounds(int w, int h) { m_width = w; m_height = h; }
-void Creature::normalize() {
-    float length = std::sqrt(m_dx * m_dx + m_dy * m_dy);
-    if (length != 0) {
-        m_dx /= length;
-        m_dy /= length;
-    }
+std::vector<std::shared_ptr<GameSprite>>& Sprites() {
+    static std::vector<std::shared_ptr<GameSprite>> sprites{nullptr}; // slot 0 is "no sprite"
+    return sprites;
 }
 
-void Creature::bounce() {
-    if (getX() + m_collisionRadius >= m_width) {
-        m_dx = -abs(m_dx);
-    }
-    else if (getX() + m_collisionRadius <= 0) {
-        m_dx = abs(m_dx);
-    }
+}
 
-    if (getY() + m_collisionRadius >= m_height) {
-        m_dy = -abs(m_dy);
-    }
-    else if (getY() + m_collisionRadius <= 0) {
-        m_dy = abs(m_dy);
+SpriteId SpriteTable::Add(std::shared_ptr<GameSprite> sprite) {
+    if (!sprite) { return 0; }
+    std::vector<std::shared_ptr<GameSprite>>& sprites = Sprites();
+    if (sprites.size() > 0xffff) {
+        ofLogError() << "Sprite table is full";
+        return 0;
     }
+    sprites.push_back(std::move(sprite));
+    return SpriteId(sprites.size() - 1);
+}
 
-    normalize();
+const GameSprite* SpriteTable::Get(SpriteId id) {
+    const std::vector<std::shared_ptr<GameSprite>>& sprites = Sprites();
+    return id < sprites.size() ? sprites[id].get() : nullptr;
 }
 
-void Creature::SetPlayer(std::shared_ptr<PlayerCreature> player) {
-    s_player = player;
+size_t SpriteTable::GetCount() {
+    return Sprites().size() - 1;
 }
 
-std::shared_ptr<PlayerCreature> Creature::GetPlayer() {
-    return s_player.lock(); // safely return a shared_ptr if still valid
+size_t SpriteTable::GetBytes() {
+    size_t bytes = 0;
+    for (const auto& sprite : Sprites()) {
+        if (sprite) { bytes += sprite->getBytes(); }
+    }
+    return bytes;
+}
+
+// Creature Inherited Base Behavior
+void Creature::normalize() {
+    float length = std::sqrt(m_dx * m_dx + m_dy * m_dy);
+    if (length != 0) {
+        m_dx /= length;
+        m_dy /= length;
+    }
+}
+
+void Creature::bounce(const WorldContext& world) {
+    BounceHeading(m_x, m_y, m_dx, m_dy, this->getCollisionRadius(), world.width, world.height);
 }
 
 void GameEvent::print() const {
@@ -45,25 +58,33 @@ void GameEvent::print() const {
                 ofLogVerbose() << "No event." << std::endl;
                 break;
             case GameEventType::COLLISION:
-                ofLogVerbose() << "Collision event between creatures at (" 
-                << creatureA->getX() << ", " << creatureA->getY() << ") and ("
-                << creatureB->getX() << ", " << creatureB->getY() << ")." << std::endl;
+                ofLogVerbose() << "Collision event between creatures " << creatureA.id << " and " << creatureB.id
+                << " at (" << x << ", " << y << ")." << std::endl;
                 break;
             case GameEventType::CREATURE_ADDED:
-                ofLogVerbose() << "Creature added at (" 
-                << creatureA->getX() << ", " << creatureA->getY() << ")." << std::endl;
+                ofLogVerbose() << "Creature " << creatureA.id << " added at (" << x << ", " << y << ")." << std::endl;
                 break;
             case GameEventType::CREATURE_REMOVED:
-                ofLogVerbose() << "Creature removed at (" 
-                << creatureA->getX() << ", " << creatureA->getY() << ")." << std::endl;
+                ofLogVerbose() << "Creature " << creatureA.id << " removed at (" << x << ", " << y << ")." << std::endl;
                 break;
             case GameEventType::GAME_OVER:
                 ofLogVerbose() << "Game Over event." << std::endl;
                 break;
+            case GameEventType::GAME_EXIT:
+                ofLogVerbose() << "Game Exit event." << std::endl;
+                break;
             case GameEventType::NEW_LEVEL:
-                ofLogVerbose() << "New Game level" << std::endl;
+                ofLogVerbose() << "New Game level " << value << std::endl;
+                break;
             case GameEventType::POWER_UP:
                 ofLogVerbose() << "Creature powered up" << std::endl;
+                break;
+            case GameEventType::PLAYER_HURT:
+                ofLogVerbose() << "Player hurt, lives left: " << value << std::endl;
+                break;
+            case GameEventType::SCENE_CHANGED:
+                ofLogVerbose() << "Scene changed to " << GameSceneKindToString(GameSceneKind(value)) << std::endl;
+                break;
             default:
                 ofLogVerbose() << "Unknown event type." << std::endl;
                 break;
@@ -71,10 +92,10 @@ void GameEvent::print() const {
 };
 
 // collision detection between two creatures
-bool checkCollision(std::shared_ptr<Creature> a, std::shared_ptr<Creature> b) {
-    float dx = a->getX() - b->getX();
-    float dy = a->getY() - b->getY();
-    float r = a->getCollisionRadius() - b->getCollisionRadius();
+bool checkCollision(const Creature& a, const Creature& b) {
+    float dx = a.getX() - b.getX();
+    float dy = a.getY() - b.getY();
+    float r = a.getCollisionRadius() - b.getCollisionRadius();
     return (dx*dx + dy*dy) <= (r*r); 
 };
 
@@ -104,6 +125,13 @@ void GameSceneManager::Transition(string name){
     if(newScene == nullptr){return;} // i dont have the scene so time to leave
     if(newScene->GetName() == this->m_active_scene->GetName()){return;} // another do nothing since active scene is already pulled
     this->m_active_scene = newScene; // now we keep it since this is a valid transition
+    if(this->m_eventBus != nullptr){
+        GameEvent event(GameEventType::SCENE_CHANGED);
+        for(GameSceneKind kind : {GameSceneKind::GAME_INTRO, GameSceneKind::AQUARIUM_GAME, GameSceneKind::GAME_OVER}){
+            if(GameSceneKindToString(kind) == name){ event.value = int(kind); }
+        }
+        this->m_eventBus->Publish(event);
+    }
     return;
 }
 
@@ -155,4 +183,20 @@ void GameOverScene::Draw(){
     ofBackgroundGradient(ofColor::red, ofColor::black);
     this->m_banner->draw(0,0);
 
-}
\ No newline at end of file
+}
+void WorldView::SetTarget(const ofRectangle& area){
+    float scale = std::min(area.width / float(WorldWidth), area.height / float(WorldHeight));
+    float width = WorldWidth * scale;
+    float height = WorldHeight * scale;
+    m_viewport = ofRectangle(area.x + (area.width - width) / 2, area.y + (area.height - height) / 2, width, height);
+}
+
+void WorldView::Begin() const{
+    ofPushView();
+    ofViewport(m_viewport);
+    ofSetupScreenOrtho(WorldWidth, WorldHeight);
+}
+
+void WorldView::End() const{
+    ofPopView();
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -5,6 +7,8 @@
 #include <algorithm>
 #include "ofMain.h"
 #include <map>
+#include "GameRandom.h"
+#include "SpriteAnimation.h"
 
 class PlayerCreature;
 class AwaitFrames {
@@ -34,15 +38,17 @@ public:
         m_flippedImage.mirror(false, true); // Mirror horizontally
     }
 
-    void draw(float x, float y) const {
-        if (m_flipped) {
+    // Flipping is up to whoever draws, so one sprite serves every creature
+    // that looks like it.
+    void draw(float x, float y, bool flipped = false) const {
+        if (flipped) {
             m_flippedImage.draw(x, y);
         } else {
             m_image.draw(x, y);
         }
     }
 
-    void drawRot(float x, float y, float rotationDeg = 0.0f) const {
+    void drawRot(float x, float y, float rotationDeg = 0.0f, bool flipped = false) const {
         ofPushMatrix();
         // Move to position
         ofTranslate(x, y);
@@ -53,7 +59,7 @@ public:
         float w = m_image.getWidth();
         float h = m_image.getHeight();
 
-        if (m_flipped) {
+        if (flipped) {
             m_flippedImage.draw(-w / 2, -h / 2);
         } else {
             m_image.draw(-w / 2, -h / 2);
@@ -62,69 +68,193 @@ public:
         ofPopMatrix();
     }
 
-    void setFlipped(bool flipped) { m_flipped = flipped; }
+    // Pixels kept on the CPU plus the textures, both orientations.
+    size_t getBytes() const {
+        return 2 * (m_image.getPixels().size() + size_t(m_image.getWidth() * m_image.getHeight() * 4));
+    }
 
 private:
     ofImage m_image;
     ofImage m_flippedImage;
-    bool m_flipped = false;
 };
 
+// Creatures refer to sprites by a 16-bit id into this table instead of
+// holding a pointer each. Sprites are added once while loading and live
+// until exit. Id 0 is "no sprite", headless creatures all have it.
+using SpriteId = uint16_t;
+class SpriteTable {
+    public:
+        static SpriteId Add(std::shared_ptr<GameSprite> sprite);
+        static const GameSprite* Get(SpriteId id);
+        static size_t GetCount();
+        static size_t GetBytes();
+};
+
+
+
+// The player as creatures see it during one tick. Copied once per tick so
+// AI code never has to reach the player object itself.
+struct PlayerSnapshot {
+    float x = 0.0f;
+    float y = 0.0f;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    int power = 0;
+    bool present = false;
+};
+
+// Logical size of the world. Everything is simulated and drawn in these
+// units and ofApp maps them onto the window with a projection, so a resize
+// never touches the world or its creatures.
+constexpr int WorldWidth = 1024;
+constexpr int WorldHeight = 768;
 
+// Maps the world onto a target of any size: the largest rectangle with the
+// world's aspect ratio, centered, and an ortho projection over it. Only the
+// rectangle is recomputed on resize.
+class WorldView {
+    public:
+        void SetTargetSize(int w, int h) { this->SetTarget(ofRectangle(0, 0, w, h)); }
+        // Any part of the window, for tiles.
+        void SetTarget(const ofRectangle& area);
+        // Everything drawn between Begin and End is in world units.
+        void Begin() const;
+        void End() const;
+        const ofRectangle& GetViewport() const { return m_viewport; }
+    private:
+        ofRectangle m_viewport{0, 0, float(WorldWidth), float(WorldHeight)};
+};
+
+// Everything a creature may read about the world while it moves. Built by
+// the scene once per tick and passed by reference, it owns nothing. Each
+// aquarium builds its own, so any number of them can run on separate threads.
+struct WorldContext {
+    PlayerSnapshot player;
+    uint64_t tick = 0;     // simulation frames since the game started
+    float time = 0.0f;     // tick in seconds at 60 ticks per second
+    float width = WorldWidth;   // bounds of the aquarium being simulated
+    float height = WorldHeight;
+    // no random engine in here on purpose, creatures that need random
+    // numbers get the aquarium's engine when they're built
+};
+
+// Plain movement state of a creature, laid out so snapshots can copy it as
+// one block.
+struct CreatureState {
+    float x = 0.0f;
+    float y = 0.0f;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    int speed = 0;
+};
 
+// Kept small, a level can hold thousands of these: no per creature bounds
+// (they come with the WorldContext), a sprite id instead of a pointer, and
+// radius/value looked up from the type instead of stored. Animated ones
+// only add an animation id and the tick it started, the batch renderer
+// works out the frame.
 class Creature {
 protected:
-    Creature(float x, float y, int speed, float collisionRadius, int value,
-             std::shared_ptr<GameSprite> sprite)
+    Creature(float x, float y, int speed, SpriteId sprite)
     : m_x(x)
     , m_y(y)
     , m_dx(0)
     , m_dy(0)
-    , m_speed(speed)
-    , m_width(0)
-    , m_height(0)
-    , m_collisionRadius(collisionRadius)
-    , m_value(value)
-    , m_sprite(std::move(sprite)) {}
+    , m_speed(int16_t(speed))
+    , m_sprite(sprite) {}
 
     float m_x = 0.0f;
     float m_y = 0.0f;
     float m_dx = 0.0f;
     float m_dy = 0.0f;
-    int m_speed = 0;
-    float m_width = 0.0f;
-    float m_height = 0.0f;
-    float m_collisionRadius = 0.0f;
-    int m_value = 0;
-    std::shared_ptr<GameSprite> m_sprite;
-    static std::weak_ptr<PlayerCreature> s_player;
+    uint32_t m_id = 0; // handed out by the aquarium, 0 until added
+    int16_t m_speed = 0; // 16 bits leave room for the animation below
+    SpriteId m_sprite = 0;
+    AnimationId m_animation = 0;
+    uint16_t m_animationStart = 0; // tick, wraps
+    bool m_flipped = false;
+
+    const GameSprite* sprite() const { return SpriteTable::Get(m_sprite); }
 
 public:
     virtual ~Creature() = default;
-    virtual void move() = 0;
+    virtual void move(const WorldContext& world) = 0;
+    // Catches up on `steps` ticks at once, for creatures the aquarium only
+    // updates every few ticks. The default just moves that many times.
+    virtual void moveSteps(const WorldContext& world, int steps) {
+        for (int i = 0; i < steps; ++i) { this->move(world); }
+    }
     virtual void draw() const = 0;
 
-    virtual float getCollisionRadius() const { return m_collisionRadius; }
-    virtual void setCollisionRadius(float radius) { m_collisionRadius = radius; }
+    virtual float getCollisionRadius() const = 0;
+    // Score when eaten, also the power needed to eat it.
+    virtual int getValue() const = 0;
 
     float getX() const { return m_x; }
     float getY() const { return m_y; }
+    float getDx() const { return m_dx; }
+    float getDy() const { return m_dy; }
     int getSpeed() const { return m_speed; }
-    void setSpeed(int speed) { m_speed = speed; }
-    void setFlipped(bool flipped) {
-        if (m_sprite) {
-            m_sprite->setFlipped(flipped);
-        }
+    void setSpeed(int speed) { m_speed = int16_t(speed); }
+    void setFlipped(bool flipped) { m_flipped = flipped; }
+    bool isFlipped() const { return m_flipped; }
+    void setSprite(SpriteId sprite) { m_sprite = sprite; }
+    SpriteId getSprite() const { return m_sprite; }
+    // 0 draws the sprite instead.
+    void setAnimation(AnimationId animation) { m_animation = animation; }
+    AnimationId getAnimation() const { return m_animation; }
+    void restartAnimation(uint64_t tick) { m_animationStart = uint16_t(tick); }
+    uint16_t getAnimationStart() const { return m_animationStart; }
+    uint32_t getId() const { return m_id; }
+    void setId(uint32_t id) { m_id = id; }
+
+    CreatureState getState() const { return CreatureState{m_x, m_y, m_dx, m_dy, m_speed}; }
+    void setState(const CreatureState& state) {
+        m_x = state.x; m_y = state.y;
+        m_dx = state.dx; m_dy = state.dy;
+        m_speed = state.speed;
     }
-    void setSprite(std::shared_ptr<GameSprite> sprite) { m_sprite = std::move(sprite); }
-    int getValue() const { return m_value; }
 
-    void setBounds(int w, int h);
     void normalize();
-    void bounce();
-
-    static void SetPlayer(std::shared_ptr<PlayerCreature> player);
-    static std::shared_ptr<PlayerCreature> GetPlayer();
+    // Turns around at the left/top edge and BounceMargin short of the
+    // right/bottom one of world's bounds, so sprites drawn from their
+    // corner stay in view.
+    void bounce(const WorldContext& world);
+    static constexpr float BounceMargin = 20.0f;
+
+    // The arithmetic of bounce() and of the straight line movers on bare
+    // floats. ArchetypeCreature and CreatureRecords both go through these,
+    // so the objects and the compact records can't move differently.
+    static void BounceHeading(float x, float y, float& dx, float& dy, float radius, float width, float height) {
+        if (x + radius >= width - BounceMargin) {
+            dx = -std::abs(dx);
+        } else if (x + radius <= 0) {
+            dx = std::abs(dx);
+        }
+        if (y + radius >= height - BounceMargin) {
+            dy = -std::abs(dy);
+        } else if (y + radius <= 0) {
+            dy = std::abs(dy);
+        }
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length != 0) {
+            dx /= length;
+            dy /= length;
+        }
+    }
+    // `step` along the heading (walkers only along x), then the bounce.
+    // Returns whether it faced left before bouncing, which is what the
+    // sprite flips on.
+    static bool StepStraight(float& x, float& y, float& dx, float& dy, float step, bool swims,
+                             float radius, float width, float height) {
+        x += dx * step;
+        if (swims) {
+            y += dy * step;
+        }
+        const bool facingLeft = dx < 0;
+        BounceHeading(x, y, dx, dy, radius, width, height);
+        return facingLeft;
+    }
 };
 
 // GameEvents
@@ -136,20 +266,34 @@ enum class GameEventType {
     GAME_OVER,
     GAME_EXIT,
     NEW_LEVEL,
-    POWER_UP
+    POWER_UP,
+    PLAYER_HURT,
+    SCENE_CHANGED,
+    COUNT // keep last, sizes the per-type listener tables
 };
 
-class GameEvent {
-    public:
-    GameEventType type;
-    std::shared_ptr<Creature> creatureA;
-    std::shared_ptr<Creature> creatureB; // For collision events
-    GameEvent() : type(GameEventType::NONE), creatureA(nullptr), creatureB(nullptr) {}
-    GameEvent(GameEventType t, std::shared_ptr<Creature> a , std::shared_ptr<Creature> b){
-        type = t;
-        creatureA = a;
-        creatureB = b;
-    }
+// Refers to a creature without owning it. `slot` is where the creature sat
+// in the aquarium when the handle was made and is only a lookup hint; `id`
+// is what identifies it. Id 0 means no creature.
+struct CreatureHandle {
+    uint32_t id = 0;
+    uint32_t slot = 0;
+    bool isValid() const { return id != 0; }
+};
+
+// Small fixed-size value, copied around freely and never heap allocated.
+struct GameEvent {
+    GameEventType type = GameEventType::NONE;
+    CreatureHandle creatureA;
+    CreatureHandle creatureB; // For collision events
+    float x = 0.0f;           // where it happened
+    float y = 0.0f;
+    int value = 0;            // NEW_LEVEL: level index, PLAYER_HURT: lives left,
+                              // CREATURE_REMOVED: creature value, SCENE_CHANGED: GameSceneKind
+
+    GameEvent() = default;
+    GameEvent(GameEventType t, CreatureHandle a = CreatureHandle(), CreatureHandle b = CreatureHandle())
+    : type(t), creatureA(a), creatureB(b) {}
     
     // Additional methods can be added here
     bool isCollisionEvent() const { return type == GameEventType::COLLISION; }
@@ -166,7 +310,7 @@ class GameEvent {
 
 
 
-bool checkCollision(std::shared_ptr<Creature> a, std::shared_ptr<Creature> b);
+bool checkCollision(const Creature& a, const Creature& b);
 
 
 class GameLevel {
@@ -226,8 +370,12 @@ class GameOverScene : public GameScene {
 };
 
 
+class GameEventBus;
+
 class GameSceneManager {
     public:
+        // Transitions are published as SCENE_CHANGED when a bus is set.
+        void SetEventBus(GameEventBus* bus) { m_eventBus = bus; }
     
         void Transition(string name);
         void AddScene(std::shared_ptr<GameScene> newScene);
@@ -243,5 +391,6 @@ class GameSceneManager {
     private:
         std::vector<std::shared_ptr<GameScene>> m_scenes;
         std::shared_ptr<GameScene> m_active_scene;
+        GameEventBus* m_eventBus = nullptr;
 
 };
\ No newline at end of file
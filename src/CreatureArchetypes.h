@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include "CreatureTypes.h"
+
+// How a type is built and moved.
+enum class CreatureKind {
+    Swimmer,       // free swimming fish
+    Walker,        // walks along the floor
+    Predator,      // head of a segmented body that chases the player
+    PredatorPart,  // body/tail sprite of a predator, never spawned alone
+    PowerUp
+};
+
+// Everything that used to be spread over the creature constructors, the
+// sprite manager and the spawn code, one row per AquariumCreatureType in
+// enum order. The table is constexpr so the per-type spawn and move code in
+// Aquarium.h/.cpp reads these as compile time constants. A new creature
+// type is an enum value plus a row here.
+struct CreatureArchetype {
+    AquariumCreatureType type;
+    CreatureKind kind;
+    const char* name;         // as written in settings.xml
+    const char* spriteFile;   // nullptr for creatures drawn without a sprite
+    int spriteSize;           // sprites are square
+    float collisionRadius;
+    int value;                // score when eaten, also the power needed to eat it
+    int minSpeed;             // spawn speed when the level doesn't set one
+    int maxSpeed;
+    float speedScale;         // multiplier on speed when moving
+    int bodySegments;         // predators only, head and tail not counted
+};
+
+constexpr CreatureArchetype CreatureArchetypes[] = {
+    // type                               kind                        name            sprite               size  radius value speed    scale segs
+    {AquariumCreatureType::NPCreature,    CreatureKind::Swimmer,      "NPCreature",   "base-fish.png",     70,   30,    1,    1, 25,   1.0f,  0},
+    {AquariumCreatureType::BiggerFish,    CreatureKind::Swimmer,      "BiggerFish",   "bigger-fish.png",   120,  60,    5,    1, 25,   0.5f,  0},
+    {AquariumCreatureType::BabyPredator,  CreatureKind::Predator,     "BabyPredator", "predator-head.png", 50,   40,    10,   9, 11,   1.0f,  4},
+    {AquariumCreatureType::Predator,      CreatureKind::Predator,     "Predator",     "predator-head.png", 50,   40,    10,   10, 10,  1.0f,  10},
+    {AquariumCreatureType::PredatorBody,  CreatureKind::PredatorPart, "PredatorBody", "predator-body.png", 50,   0,     0,    0, 0,    1.0f,  0},
+    {AquariumCreatureType::PredatorTail,  CreatureKind::PredatorPart, "PredatorTail", "predator-tail.png", 50,   0,     0,    0, 0,    1.0f,  0},
+    {AquariumCreatureType::Crab,          CreatureKind::Walker,       "Crab",         "crab.png",          50,   60,    5,    1, 25,   1.0f,  0},
+    {AquariumCreatureType::SpeedPowerUp,  CreatureKind::PowerUp,      "SpeedPowerUp", nullptr,             0,    14,    0,    0, 0,    0.0f,  0},
+};
+
+constexpr size_t CreatureArchetypeCount = sizeof(CreatureArchetypes) / sizeof(CreatureArchetypes[0]);
+static_assert(CreatureArchetypeCount == size_t(AquariumCreatureType::Count), "one archetype row per AquariumCreatureType");
+
+constexpr bool ArchetypesInEnumOrder(size_t i = 0) {
+    return i == CreatureArchetypeCount ||
+           (size_t(CreatureArchetypes[i].type) == i && ArchetypesInEnumOrder(i + 1));
+}
+static_assert(ArchetypesInEnumOrder(), "archetype rows must follow the AquariumCreatureType order");
+
+constexpr const CreatureArchetype& GetArchetype(AquariumCreatureType type) {
+    return CreatureArchetypes[size_t(type)];
+}
+
+constexpr bool IsPredatorType(AquariumCreatureType type) {
+    return GetArchetype(type).kind == CreatureKind::Predator;
+}
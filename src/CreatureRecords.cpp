@@ -0,0 +1,67 @@
+#include "CreatureRecords.h"
+#include "Aquarium.h"
+
+namespace {
+
+// The few archetype fields Step() needs, packed so they stay in cache.
+struct RecordMotion {
+    float speedScale = 0.0f;
+    float radius = 0.0f;
+    bool swims = false;
+    bool movable = false;
+};
+
+const RecordMotion* Motions() {
+    static const std::array<RecordMotion, CreatureArchetypeCount> motions = [] {
+        std::array<RecordMotion, CreatureArchetypeCount> table{};
+        for (const CreatureArchetype& archetype : CreatureArchetypes) {
+            RecordMotion& motion = table[size_t(archetype.type)];
+            motion.speedScale = archetype.speedScale;
+            motion.radius = archetype.collisionRadius;
+            motion.swims = archetype.kind == CreatureKind::Swimmer;
+            motion.movable = archetype.kind == CreatureKind::Swimmer || archetype.kind == CreatureKind::Walker;
+        }
+        return table;
+    }();
+    return motions.data();
+}
+
+}
+
+bool CreatureRecords::Add(AquariumCreatureType type, float x, float y, float dx, float dy, int speed, SpriteId sprite) {
+    if (size_t(type) >= CreatureArchetypeCount || !Motions()[size_t(type)].movable) { return false; }
+    CreatureRecord record;
+    record.x = x;
+    record.y = y;
+    record.dx = dx;
+    record.dy = dy;
+    record.speed = int16_t(speed);
+    record.type = uint8_t(type);
+    record.sprite = sprite;
+    record.flags = dx < 0 ? CreatureRecord::Flipped : 0;
+    m_records.push_back(record);
+    return true;
+}
+
+void CreatureRecords::CopyFrom(const Aquarium& aquarium) {
+    for (const auto& creature : aquarium.getCreatures()) {
+        const NPCreature* npc = dynamic_cast<const NPCreature*>(creature.get());
+        if (!npc) { continue; }
+        if (this->Add(npc->GetType(), npc->getX(), npc->getY(), npc->getDx(), npc->getDy(), npc->getSpeed(), npc->getSprite())) {
+            m_records.back().animation = npc->getAnimation();
+            m_records.back().animationStart = npc->getAnimationStart();
+        }
+    }
+}
+
+void CreatureRecords::Step(float width, float height, int steps) {
+    const RecordMotion* motions = Motions();
+    for (CreatureRecord& record : m_records) {
+        const RecordMotion& motion = motions[record.type];
+        // the same kernel as ArchetypeCreature::moveSteps
+        const float step = record.speed * motion.speedScale * steps;
+        const bool flipped = Creature::StepStraight(record.x, record.y, record.dx, record.dy, step, motion.swims,
+                                                    motion.radius, width, height);
+        record.flags = uint8_t(flipped ? (record.flags | CreatureRecord::Flipped) : (record.flags & ~CreatureRecord::Flipped));
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core.h"
+#include "CreatureTypes.h"
+
+class Aquarium;
+
+// A simple NPC (fish or crab) as plain data: no vtable, no shared_ptr, no
+// bounds, radius or value, those all come from the type's archetype row
+// and the aquarium. Used where we want lots of them at once, like
+// million-creature headless runs.
+struct CreatureRecord {
+    float x = 0.0f;
+    float y = 0.0f;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    int16_t speed = 0;
+    uint8_t type = 0;      // AquariumCreatureType
+    uint8_t flags = 0;
+    SpriteId sprite = 0;
+    AnimationId animation = 0;
+    uint16_t animationStart = 0;
+
+    static constexpr uint8_t Flipped = 1;
+};
+static_assert(sizeof(CreatureRecord) < 32, "simple NPCs should stay under 32 bytes");
+static_assert(size_t(AquariumCreatureType::Count) <= 256, "record types are one byte");
+
+// Flat array of records, moved by the same Creature::StepStraight kernel
+// ArchetypeCreature uses, so the two can't drift apart.
+class CreatureRecords {
+    public:
+        void Reserve(size_t count) { m_records.reserve(count); }
+        void Clear() { m_records.clear(); }
+        // False for types that aren't swimmers or walkers.
+        bool Add(AquariumCreatureType type, float x, float y, float dx, float dy, int speed, SpriteId sprite = 0);
+        // Copies the fish and crabs of an aquarium, the rest is skipped.
+        void CopyFrom(const Aquarium& aquarium);
+
+        // `steps` ticks of straight line movement and bouncing in a
+        // width x height aquarium.
+        void Step(float width, float height, int steps = 1);
+
+        size_t size() const { return m_records.size(); }
+        const CreatureRecord& operator[](size_t i) const { return m_records[i]; }
+        size_t GetBytes() const { return m_records.capacity() * sizeof(CreatureRecord); }
+
+    private:
+        std::vector<CreatureRecord> m_records;
+};
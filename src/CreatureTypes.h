@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+enum class AquariumCreatureType {
+    NPCreature,
+    BiggerFish,
+    BabyPredator,
+    Predator,
+    PredatorBody,
+    PredatorTail,
+    Crab,
+    SpeedPowerUp,
+    Count // not a creature, keep last
+};
+
+enum class PlayerType {
+    Pirahna,
+    Shark,
+    Whale
+};
+
+std::string AquariumCreatureTypeToString(AquariumCreatureType t);
+// Accepts the enum names used in settings.xml ("NPCreature", "Crab", ...).
+bool AquariumCreatureTypeFromString(const std::string& name, AquariumCreatureType& out);
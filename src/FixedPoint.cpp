@@ -0,0 +1,104 @@
+#include "FixedPoint.h"
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr int TableSteps = 1024; // per turn, a power of two so wrapping is a mask
+
+// sin(r * pi/2 / 256) for r in [0, 256] from its Taylor series, in Q2.30
+// integers so the table is the same bits on every compiler. Terms up to
+// x^13 are well below the 1/65536 we keep.
+constexpr int64_t QuarterSin(int r) {
+    const int64_t halfPi = 1686629713; // pi/2 * 2^30
+    const int64_t x = halfPi * r / 256;
+    const int64_t x2 = (x * x) >> 30;
+    // magnitudes only, shifting negative numbers is up to the compiler
+    int64_t term = x;
+    int64_t sum = x;
+    for (int n = 1; n <= 6; ++n) {
+        term = ((term * x2) >> 30) / ((2 * n) * (2 * n + 1));
+        sum += (n % 2 == 1) ? -term : term;
+    }
+    return sum;
+}
+
+constexpr std::array<int32_t, TableSteps + 1> MakeSinTable() {
+    std::array<int32_t, TableSteps + 1> table{};
+    const int quarter = TableSteps / 4;
+    for (int k = 0; k <= TableSteps; ++k) {
+        int q = (k / quarter) % 4;
+        int r = k % quarter;
+        int64_t s = (q == 0 || q == 2) ? QuarterSin(r) : QuarterSin(quarter - r);
+        int32_t value = int32_t((s + (1 << 13)) >> 14); // Q30 to Q16, rounded
+        table[size_t(k)] = q >= 2 ? -value : value;
+    }
+    return table;
+}
+
+constexpr std::array<int32_t, TableSteps + 1> SinTable = MakeSinTable();
+
+// Angle to a position on the table with 16 bits of fraction.
+int64_t TablePosition(Fixed radians) {
+    int64_t turn = int64_t(radians.raw) % FixedMath::TwoPi.raw;
+    if (turn < 0) { turn += FixedMath::TwoPi.raw; }
+    return turn * TableSteps * Fixed::OneRaw / FixedMath::TwoPi.raw;
+}
+
+Fixed TableLookup(int64_t position) {
+    const size_t i = size_t(position >> 16) & (TableSteps - 1);
+    const int64_t frac = position & 0xffff;
+    const int64_t a = SinTable[i];
+    const int64_t b = SinTable[i + 1];
+    return Fixed::FromRaw(int32_t(a + (b - a) * frac / 65536));
+}
+
+uint64_t IntegerSqrt(uint64_t n) {
+    // the double root is only a first guess, the two loops below make it
+    // exactly floor(sqrt(n)) whatever the FPU did, so the result is still
+    // the same everywhere
+    uint64_t root = uint64_t(std::sqrt(double(n)));
+    while (root > 0 && (root > 0xffffffffull || root * root > n)) { --root; }
+    while (root < 0xffffffffull && (root + 1) * (root + 1) <= n) { ++root; }
+    return root;
+}
+}
+
+Fixed Fixed::FromFloat(float value) {
+    return FromRaw(int32_t(std::llround(double(value) * OneRaw)));
+}
+
+Fixed FixedMath::Length(Fixed dx, Fixed dy) {
+    // the squares carry 32 fraction bits, their root comes back with 16
+    return Fixed::FromRaw(int32_t(IntegerSqrt(uint64_t(DistanceSq(dx, dy)))));
+}
+
+void FixedMath::Normalize(Fixed& x, Fixed& y) {
+    Fixed length = Length(x, y);
+    if (length.raw != 0) {
+        x = x / length;
+        y = y / length;
+    }
+}
+
+Fixed FixedMath::Sqrt(Fixed f) {
+    if (f.raw <= 0) { return Fixed(); }
+    return Fixed::FromRaw(int32_t(IntegerSqrt(uint64_t(f.raw) << 16)));
+}
+
+Fixed FixedMath::Sin(Fixed radians) {
+    return TableLookup(TablePosition(radians));
+}
+
+Fixed FixedMath::Cos(Fixed radians) {
+    // a quarter turn ahead on the same table
+    return TableLookup(TablePosition(radians) + int64_t(TableSteps / 4) * Fixed::OneRaw);
+}
+
+Fixed FixedMath::TickAngle(uint64_t tick, Fixed radiansPerSecond) {
+    const uint64_t turn = uint64_t(TwoPi.raw) * 60;
+    const uint64_t rate = uint64_t(int64_t(radiansPerSecond.raw) < 0 ? -int64_t(radiansPerSecond.raw) : radiansPerSecond.raw);
+    // (tick * rate) mod (turn * 60) without overflowing: reduce tick first
+    const uint64_t angle = ((tick % turn) * rate) % turn / 60;
+    return radiansPerSecond.raw < 0 ? -Fixed::FromRaw(int32_t(angle)) : Fixed::FromRaw(int32_t(angle));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+// Q16.16 fixed point: 16 integer bits (about +-32768, the world is 1024
+// wide) and 16 fraction bits (1/65536). Only integer math, so the same
+// inputs give the same bits with any compiler, flags or CPU. Products and
+// quotients go through 64 bits and truncate. Squared distances don't fit
+// in 32 bits, use DistanceSq/Length for those.
+struct Fixed {
+    int32_t raw = 0;
+
+    static constexpr int FractionBits = 16;
+    static constexpr int32_t OneRaw = 1 << FractionBits;
+
+    static constexpr Fixed FromRaw(int32_t raw) { Fixed f; f.raw = raw; return f; }
+    static constexpr Fixed FromInt(int value) { return FromRaw(value * OneRaw); }
+    // num/den, for constants like 1/2 without going through a float.
+    static constexpr Fixed FromRatio(int num, int den) { return FromRaw(int32_t(int64_t(num) * OneRaw / den)); }
+    // Nearest step. For bringing float state in; the same float always
+    // gives the same Fixed, but nothing inside the fixed path uses this.
+    static Fixed FromFloat(float value);
+    float ToFloat() const { return raw / float(OneRaw); }
+
+    constexpr Fixed operator-() const { return FromRaw(-raw); }
+    constexpr Fixed operator+(Fixed o) const { return FromRaw(raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const { return FromRaw(raw - o.raw); }
+    constexpr Fixed operator*(Fixed o) const { return FromRaw(int32_t((int64_t(raw) * o.raw) / OneRaw)); }
+    constexpr Fixed operator/(Fixed o) const { return FromRaw(int32_t(int64_t(raw) * OneRaw / o.raw)); }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+
+    constexpr bool operator<(Fixed o) const { return raw < o.raw; }
+    constexpr bool operator>(Fixed o) const { return raw > o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+    constexpr bool operator!=(Fixed o) const { return raw != o.raw; }
+};
+
+namespace FixedMath {
+    constexpr Fixed Pi = Fixed::FromRaw(205887);     // pi * 65536, rounded
+    constexpr Fixed TwoPi = Fixed::FromRaw(411775);
+
+    constexpr Fixed Abs(Fixed f) { return f.raw < 0 ? -f : f; }
+    // dx^2 + dy^2 with 32 fraction bits, for comparing against Square(r).
+    constexpr int64_t DistanceSq(Fixed dx, Fixed dy) { return int64_t(dx.raw) * dx.raw + int64_t(dy.raw) * dy.raw; }
+    constexpr int64_t Square(Fixed f) { return int64_t(f.raw) * f.raw; }
+    // sqrt(dx^2 + dy^2), bit exact (integer square root, rounded down).
+    Fixed Length(Fixed dx, Fixed dy);
+    Fixed Sqrt(Fixed f);
+    // To unit length, left alone when it is zero (Creature::normalize).
+    void Normalize(Fixed& x, Fixed& y);
+
+    // From a 1024 step table over the full turn, linearly interpolated.
+    // Any angle works, it is wrapped into one turn first.
+    Fixed Sin(Fixed radians);
+    Fixed Cos(Fixed radians);
+    // `radiansPerSecond * tick / 60` wrapped into one turn, computed in 64
+    // bits so it doesn't overflow however long the game runs.
+    Fixed TickAngle(uint64_t tick, Fixed radiansPerSecond);
+}
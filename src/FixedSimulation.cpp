@@ -0,0 +1,287 @@
+#include "FixedSimulation.h"
+#include "Aquarium.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+const Fixed Margin = Fixed::FromInt(int(Creature::BounceMargin));
+const Fixed Spacing = Fixed::FromInt(int(Predator::SegmentSpacing));
+const Fixed HeadHit = Fixed::FromInt(int(Predator::HeadHitRadius));
+const Fixed BodyHit = Fixed::FromInt(int(Predator::BodyHitRadius));
+const Fixed TailHit = Fixed::FromInt(int(Predator::TailHitRadius));
+const Fixed WobbleRate = Fixed::FromInt(4);       // radians per second, as in Predator::move
+const Fixed WobbleSize = Fixed::FromRatio(1, 2);
+const Fixed MinLength = Fixed::FromRaw(7);         // ~0.0001
+
+void Mix(uint64_t& hash, int32_t value) {
+    uint32_t bits = uint32_t(value);
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (bits >> (i * 8)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+}
+
+}
+
+void FixedSimulation::SetPlayer(Vec position, int speed, Fixed radius) {
+    m_player = position;
+    m_playerSpeed = Fixed::FromInt(speed);
+    m_playerRadius = radius;
+}
+
+bool FixedSimulation::AddCreature(AquariumCreatureType type, Vec position, Vec direction, int speed) {
+    const CreatureArchetype& archetype = GetArchetype(type);
+    if (archetype.kind != CreatureKind::Swimmer && archetype.kind != CreatureKind::Walker) { return false; }
+    Creature creature;
+    creature.position = position;
+    creature.direction = direction;
+    // the scales in the table are exact in Q16.16 (1, 0.5)
+    creature.step = Fixed::FromInt(speed) * Fixed::FromFloat(archetype.speedScale);
+    creature.radius = Fixed::FromFloat(archetype.collisionRadius);
+    creature.swims = archetype.kind == CreatureKind::Swimmer;
+    m_creatures.push_back(creature);
+    return true;
+}
+
+void FixedSimulation::AddPredator(AquariumCreatureType type, Vec head, int speed) {
+    Predator predator;
+    predator.offset = m_segments.size();
+    predator.count = GetArchetype(type).bodySegments + 2;
+    predator.speed = Fixed::FromInt(std::max(0, speed * 2));
+    for (int i = 0; i < predator.count; ++i) {
+        m_segments.push_back(Vec{head.x - Spacing * Fixed::FromInt(i), head.y});
+    }
+    Creature entry;
+    entry.position = head;
+    entry.predator = int(m_predators.size());
+    m_predators.push_back(predator);
+    m_creatures.push_back(entry);
+}
+
+void FixedSimulation::CopyFrom(const Aquarium& aquarium, const PlayerCreature& player) {
+    this->Clear();
+    m_width = Fixed::FromInt(aquarium.getWidth());
+    m_height = Fixed::FromInt(aquarium.getHeight());
+    this->SetPlayer(Vec{Fixed::FromFloat(player.getX()), Fixed::FromFloat(player.getY())}, player.getSpeed(),
+                    Fixed::FromFloat(player.getCollisionRadius()));
+    for (const auto& creature : aquarium.getCreatures()) {
+        const NPCreature* npc = dynamic_cast<const NPCreature*>(creature.get());
+        if (!npc) { continue; }
+        Vec position{Fixed::FromFloat(npc->getX()), Fixed::FromFloat(npc->getY())};
+        if (auto predator = dynamic_cast<const ::Predator*>(npc)) {
+            // keep the body where it is instead of laying it out again
+            this->AddPredator(npc->GetType(), position, npc->getSpeed());
+            ChainView segments = predator->getSegments();
+            const Predator& added = m_predators.back();
+            for (int i = 0; i < added.count && size_t(i) < segments.size(); ++i) {
+                m_segments[added.offset + size_t(i)] = Vec{Fixed::FromFloat(segments.x(size_t(i))), Fixed::FromFloat(segments.y(size_t(i)))};
+            }
+        } else {
+            this->AddCreature(npc->GetType(), position, Vec{Fixed::FromFloat(npc->getDx()), Fixed::FromFloat(npc->getDy())},
+                              npc->getSpeed());
+        }
+    }
+}
+
+void FixedSimulation::Clear() {
+    m_creatures.clear();
+    m_predators.clear();
+    m_segments.clear();
+    m_tick = 0;
+    m_lastHit = -1;
+}
+
+void FixedSimulation::bounce(Vec& position, Vec& direction, Fixed radius) const {
+    // Creature::bounce
+    if (position.x + radius >= m_width - Margin) {
+        direction.x = -FixedMath::Abs(direction.x);
+    } else if (position.x + radius <= Fixed()) {
+        direction.x = FixedMath::Abs(direction.x);
+    }
+    if (position.y + radius >= m_height - Margin) {
+        direction.y = -FixedMath::Abs(direction.y);
+    } else if (position.y + radius <= Fixed()) {
+        direction.y = FixedMath::Abs(direction.y);
+    }
+    FixedMath::Normalize(direction.x, direction.y);
+}
+
+void FixedSimulation::Step(Vec direction) {
+    ++m_tick;
+
+    // PlayerCreature::setDirection and move
+    m_playerDirection = direction;
+    FixedMath::Normalize(m_playerDirection.x, m_playerDirection.y);
+    this->bounce(m_player, m_playerDirection, m_playerRadius);
+    m_player.x += m_playerDirection.x * m_playerSpeed;
+    m_player.y += m_playerDirection.y * m_playerSpeed;
+
+    // every predator wobbles the same way this tick
+    const Fixed wobble = FixedMath::Sin(FixedMath::TickAngle(m_tick, WobbleRate)) * WobbleSize;
+    const Fixed c = FixedMath::Cos(wobble);
+    const Fixed s = FixedMath::Sin(wobble);
+
+    for (Creature& creature : m_creatures) {
+        if (creature.predator >= 0) {
+            // Predator::move, only the head, the body follows below
+            Vec& head = m_segments[m_predators[size_t(creature.predator)].offset];
+            Vec toPlayer{m_player.x - head.x, m_player.y - head.y};
+            Fixed length = FixedMath::Length(toPlayer.x, toPlayer.y);
+            if (length > MinLength) {
+                toPlayer.x = toPlayer.x / length;
+                toPlayer.y = toPlayer.y / length;
+            }
+            const Fixed speed = m_predators[size_t(creature.predator)].speed;
+            head.x += (toPlayer.x * c - toPlayer.y * s) * speed;
+            head.y += (toPlayer.x * s + toPlayer.y * c) * speed;
+            creature.position = head;
+            continue;
+        }
+        // ArchetypeCreature::moveSteps, one step
+        creature.position.x += creature.direction.x * creature.step;
+        if (creature.swims) {
+            creature.position.y += creature.direction.y * creature.step;
+        }
+        this->bounce(creature.position, creature.direction, creature.radius);
+    }
+
+    // PredatorChainPool::Solve
+    for (const Predator& predator : m_predators) {
+        for (int i = 1; i < predator.count; ++i) {
+            const Vec& lead = m_segments[predator.offset + size_t(i) - 1];
+            Vec& segment = m_segments[predator.offset + size_t(i)];
+            Vec gap{lead.x - segment.x, lead.y - segment.y};
+            Fixed distance = FixedMath::Length(gap.x, gap.y);
+            if (distance.raw == 0) { continue; }
+            // gap * (distance - spacing) / distance in one go, the factor
+            // alone overflows when two segments sit almost on each other
+            const int64_t pull = (distance - Spacing).raw;
+            segment.x += Fixed::FromRaw(int32_t(int64_t(gap.x.raw) * pull / distance.raw));
+            segment.y += Fixed::FromRaw(int32_t(int64_t(gap.y.raw) * pull / distance.raw));
+        }
+    }
+
+    // DetectAquariumCollisions, first hit in order
+    m_lastHit = -1;
+    for (size_t i = 0; i < m_creatures.size() && m_lastHit < 0; ++i) {
+        const Creature& creature = m_creatures[i];
+        if (creature.predator >= 0) {
+            const Predator& predator = m_predators[size_t(creature.predator)];
+            for (int s = 0; s < predator.count; ++s) {
+                const Vec& segment = m_segments[predator.offset + size_t(s)];
+                Fixed radius = s == 0 ? HeadHit : s == predator.count - 1 ? TailHit : BodyHit;
+                if (FixedMath::DistanceSq(segment.x - m_player.x, segment.y - m_player.y) < FixedMath::Square(radius)) {
+                    m_lastHit = int(i);
+                    break;
+                }
+            }
+        } else {
+            // checkCollision, radius difference and all
+            Fixed r = m_playerRadius - creature.radius;
+            if (FixedMath::DistanceSq(m_player.x - creature.position.x, m_player.y - creature.position.y) <= FixedMath::Square(r)) {
+                m_lastHit = int(i);
+            }
+        }
+    }
+}
+
+uint64_t FixedSimulation::Hash() const {
+    uint64_t hash = 14695981039346656037ull;
+    Mix(hash, int32_t(m_tick));
+    Mix(hash, m_player.x.raw);
+    Mix(hash, m_player.y.raw);
+    for (const Creature& creature : m_creatures) {
+        Mix(hash, creature.position.x.raw);
+        Mix(hash, creature.position.y.raw);
+        Mix(hash, creature.direction.x.raw);
+        Mix(hash, creature.direction.y.raw);
+    }
+    for (const Vec& segment : m_segments) {
+        Mix(hash, segment.x.raw);
+        Mix(hash, segment.y.raw);
+    }
+    return hash;
+}
+
+int RunFixedReplay(const FixedReplayOptions& options) {
+    ofSetLogLevel(OF_LOG_WARNING);
+    Profiler::SetEnabled(false);
+
+    Aquarium aquarium(WorldWidth, WorldHeight, nullptr);
+    aquarium.seed(options.seed);
+    aquarium.setLevelTable(LevelTable::Defaults());
+    aquarium.getSpawnScheduler().SetBudget(0, 0);
+    aquarium.Repopulate();
+    for (int p = 0; p < options.predators; ++p) {
+        aquarium.SpawnCreature(p % 2 ? AquariumCreatureType::Predator : AquariumCreatureType::BabyPredator);
+    }
+    PlayerCreature player(WorldWidth / 2.0f - 50, WorldHeight / 2.0f - 50, 5, 0);
+
+    FixedSimulation sim;
+    sim.CopyFrom(aquarium, player);
+    std::vector<Predator*> predators;
+    for (const auto& creature : aquarium.getCreatures()) {
+        if (auto predator = dynamic_cast<Predator*>(creature.get())) { predators.push_back(predator); }
+    }
+
+    std::cout << "[fixed replay] seed " << options.seed << ", " << sim.GetCreatureCount() << " creatures, "
+              << sim.GetPredatorCount() << " predators, " << options.ticks << " ticks" << std::endl;
+
+    // two radians a second at speed 5 is a 150 px circle, clear of the walls
+    const Fixed turnRate = Fixed::FromInt(2);
+    WorldContext world;
+    int hits = 0;
+    float drift = 0.0f, worstDrift = 0.0f;
+    std::vector<float> xs, ys;
+    for (int t = 1; t <= options.ticks; ++t) {
+        Fixed angle = FixedMath::TickAngle(uint64_t(t), turnRate);
+        sim.Step(FixedSimulation::Vec{FixedMath::Cos(angle), FixedMath::Sin(angle)});
+        hits += sim.GetLastHit() >= 0;
+
+        // the same tick in float, only what the fixed path covers for predators
+        world.tick = uint64_t(t);
+        world.time = t / 60.0f;
+        player.setDirection(std::cos(world.time * 2.0f), std::sin(world.time * 2.0f));
+        player.move(world);
+        world.player = player.snapshot();
+        aquarium.gatherSchooling(world);
+        aquarium.moveCreatures(world, MoveGroup::Predators);
+        aquarium.solveChains();
+        for (size_t p = 0; p < predators.size(); ++p) {
+            const FixedSimulation::Vec& head = sim.GetSegment(p, 0);
+            drift = std::max(drift, std::hypot(head.x.ToFloat() - predators[p]->getX(), head.y.ToFloat() - predators[p]->getY()));
+        }
+
+        if (t % 60 == 0 || t == options.ticks) {
+            char line[96];
+            std::snprintf(line, sizeof(line), "  %6d  %016llx  hits %d  predator drift %.3f px", t,
+                          (unsigned long long)sim.Hash(), hits, drift);
+            std::cout << line << std::endl;
+            worstDrift = std::max(worstDrift, drift);
+            drift = 0.0f;
+
+            // start the next second from the fixed state
+            CreatureState state = player.getState();
+            state.x = sim.GetPlayer().x.ToFloat();
+            state.y = sim.GetPlayer().y.ToFloat();
+            player.setState(state);
+            for (size_t p = 0; p < predators.size(); ++p) {
+                xs.clear();
+                ys.clear();
+                for (size_t s = 0; s < sim.GetSegmentCount(p); ++s) {
+                    xs.push_back(sim.GetSegment(p, s).x.ToFloat());
+                    ys.push_back(sim.GetSegment(p, s).y.ToFloat());
+                }
+                CreatureState head = predators[p]->getState();
+                head.x = xs[0];
+                head.y = ys[0];
+                predators[p]->setState(head);
+                predators[p]->restoreSegments(xs.data(), ys.data(), int(xs.size()));
+            }
+        }
+    }
+    std::cout << "  worst drift in a second: " << worstDrift << " px" << std::endl;
+    return 0;
+}
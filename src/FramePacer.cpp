@@ -0,0 +1,50 @@
+#include "FramePacer.h"
+#include <algorithm>
+
+void FramePacer::SetTargetFps(float fps) {
+    m_budgetMicros = 1000000.0f / std::max(fps, 1.0f);
+}
+
+void FramePacer::SetLevel(int level) {
+    level = std::max(0, std::min(level, QualityLevelCount - 1));
+    if (level == m_level) { return; }
+    m_level = level;
+    m_overFrames = 0;
+    m_underFrames = 0;
+    m_cooldown = cooldownFrames;
+    ++m_changes;
+}
+
+bool FramePacer::Observe(uint64_t updateMicros, uint64_t drawMicros) {
+    m_updateMicros = updateMicros;
+    m_drawMicros = drawMicros;
+
+    // a single hitch (loading a level, a GC in the driver) shouldn't count
+    // for much, a run of slow frames should
+    float frame = float(updateMicros + drawMicros);
+    m_average = m_average == 0.0f ? frame : m_average + (frame - m_average) * 0.1f;
+
+    if (m_cooldown > 0) {
+        --m_cooldown;
+        return false;
+    }
+    if (!m_adaptive) { return false; }
+
+    if (m_average > m_budgetMicros * overloadRatio) {
+        m_underFrames = 0;
+        if (++m_overFrames >= overloadFrames && m_level + 1 < QualityLevelCount) {
+            this->SetLevel(m_level + 1);
+            return true;
+        }
+    } else if (m_average < m_budgetMicros * headroomRatio) {
+        m_overFrames = 0;
+        if (++m_underFrames >= headroomFrames && m_level > 0) {
+            this->SetLevel(m_level - 1);
+            return true;
+        }
+    } else {
+        m_overFrames = 0;
+        m_underFrames = 0;
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// What each quality step turns down. Row 0 is full quality.
+struct QualitySettings {
+    const char* name;
+    int predatorLodStep;     // draw every n-th predator body segment
+    size_t particleBudget;   // live particles allowed at once
+    int farUpdateInterval;   // creatures far from the player move every n-th tick
+    bool drawBackground;
+};
+
+constexpr QualitySettings QualityLevels[] = {
+    // name       lod  particles  far  background
+    {"full",      1,   65536,     1,   true},
+    {"high",      1,   16384,     2,   true},
+    {"medium",    2,   4096,      3,   true},
+    {"low",       3,   1024,      4,   false},
+};
+constexpr int QualityLevelCount = int(sizeof(QualityLevels) / sizeof(QualityLevels[0]));
+
+// Watches how long update + draw take on the CPU each frame and steps the
+// quality down when the frame keeps going over budget, and back up once
+// there has been headroom for a while. The thresholds are far apart and a
+// change is followed by a cooldown, so it doesn't flip every other frame.
+// Only the CPU side is measured, time spent waiting on vsync or the GPU
+// doesn't count against the budget.
+class FramePacer {
+    public:
+        explicit FramePacer(float targetFps = 60.0f) { this->SetTargetFps(targetFps); }
+
+        void SetTargetFps(float fps);
+        // Feed one frame. Returns true when the quality level changed.
+        bool Observe(uint64_t updateMicros, uint64_t drawMicros);
+
+        int GetLevel() const { return m_level; }
+        const QualitySettings& GetQuality() const { return QualityLevels[m_level]; }
+        void SetLevel(int level);
+        // Turn off to pin the current level (F8).
+        void SetAdaptive(bool adaptive) { m_adaptive = adaptive; m_overFrames = m_underFrames = 0; }
+        bool IsAdaptive() const { return m_adaptive; }
+
+        float GetBudgetMs() const { return m_budgetMicros / 1000.0f; }
+        float GetAverageMs() const { return m_average / 1000.0f; } // smoothed update + draw
+        float GetUpdateMs() const { return m_updateMicros / 1000.0f; }
+        float GetDrawMs() const { return m_drawMicros / 1000.0f; }
+        uint64_t GetChangeCount() const { return m_changes; }
+
+        // Fractions of the budget the smoothed frame time is compared against.
+        float overloadRatio = 0.85f;
+        float headroomRatio = 0.5f;
+        int overloadFrames = 20;   // this many frames over budget steps down
+        int headroomFrames = 180;  // this many frames with headroom steps up
+        int cooldownFrames = 90;   // no change for this long after one
+
+    private:
+        float m_budgetMicros = 0.0f;
+        float m_average = 0.0f;
+        uint64_t m_updateMicros = 0;
+        uint64_t m_drawMicros = 0;
+        int m_level = 0;
+        int m_overFrames = 0;
+        int m_underFrames = 0;
+        int m_cooldown = 0;
+        uint64_t m_changes = 0;
+        bool m_adaptive = true;
+};
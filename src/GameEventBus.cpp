@@ -0,0 +1,24 @@
+#include "GameEventBus.h"
+
+void GameEventBus::Subscribe(GameEventType type, Listener listener) {
+    m_listeners[size_t(type)].push_back(std::move(listener));
+}
+
+void GameEventBus::Publish(const GameEvent& event) {
+    if (m_count == Capacity) {
+        ++m_dropped;
+        return;
+    }
+    m_arena[m_count++] = event;
+}
+
+void GameEventBus::Dispatch() {
+    // m_count can grow while we walk, listeners are allowed to publish
+    for (size_t i = 0; i < m_count; ++i) {
+        const GameEvent event = m_arena[i];
+        for (const Listener& listener : m_listeners[size_t(event.type)]) {
+            listener(event);
+        }
+    }
+    m_count = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+#include "Core.h"
+
+// Publish/subscribe hub for GameEvents. Events published during a frame are
+// stored by value in a fixed arena and handed to the listeners of their type
+// when Dispatch() runs, after which the arena is reused for the next frame.
+// Publishing and dispatching never allocate; only Subscribe() does, and that
+// happens during setup.
+class GameEventBus {
+    public:
+        static constexpr size_t Capacity = 256; // events per frame
+
+        using Listener = std::function<void(const GameEvent&)>;
+
+        void Subscribe(GameEventType type, Listener listener);
+
+        // Queues the event for this frame. If the arena is full the event is
+        // dropped and counted in GetDroppedCount().
+        void Publish(const GameEvent& event);
+
+        // Delivers every queued event in publish order, including events
+        // published by listeners while dispatching, then empties the arena.
+        void Dispatch();
+
+        size_t GetPendingCount() const { return m_count; }
+        size_t GetDroppedCount() const { return m_dropped; }
+
+    private:
+        std::array<GameEvent, Capacity> m_arena;
+        size_t m_count = 0;
+        size_t m_dropped = 0;
+        std::array<std::vector<Listener>, size_t(GameEventType::COUNT)> m_listeners;
+};
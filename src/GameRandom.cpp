@@ -0,0 +1,22 @@
+#include "GameRandom.h"
+
+int GameRandom::Below(GameRng& rng, int n) {
+    if (n <= 1) { return 0; }
+    // Lemire's multiply-shift, redrawing the few values that would make the
+    // low results come up more often
+    const uint64_t range = uint64_t(n);
+    uint64_t m = uint64_t(uint32_t(rng())) * range;
+    if (uint32_t(m) < range) {
+        const uint32_t threshold = uint32_t(-uint32_t(range)) % uint32_t(range);
+        while (uint32_t(m) < threshold) {
+            m = uint64_t(uint32_t(rng())) * range;
+        }
+    }
+    return int(m >> 32);
+}
+
+float GameRandom::Range(GameRng& rng, float low, float high) {
+    // top 24 bits, exactly what a float holds, in [0, 1)
+    const float unit = float(uint32_t(rng()) >> 8) * 0x1p-24f;
+    return low + (high - low) * unit;
+}
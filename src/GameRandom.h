@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+// Engine used by the simulation. Every Aquarium owns one and hands it to its
+// creatures when it builds them, so tanks never share random state and
+// seeding an aquarium makes its game reproducible.
+using GameRng = std::mt19937;
+
+// The std distributions are free to differ between standard libraries, so
+// these map the engine's raw 32 bit output themselves. mt19937 is fully
+// specified, so the same seed gives the same numbers with libstdc++, libc++
+// and MSVC alike.
+namespace GameRandom {
+    int Below(GameRng& rng, int n);                  // uniform in [0, n)
+    float Range(GameRng& rng, float low, float high);
+}
@@ -0,0 +1,291 @@
+#include "GoldenFrames.h"
+#include "Aquarium.h"
+#include "ofMain.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct GoldenCase {
+    const char* name;
+    uint32_t seed;
+    int level;   // row of LevelTable::Defaults()
+    int ticks;   // simulated before the frame is taken
+    int width;   // size of the rendered frame, the world is always the same
+    int height;
+};
+
+const GoldenCase Cases[] = {
+    {"school",         1, 0, 180, 1024, 768},
+    {"crabs",          2, 1, 240, 1024, 768},
+    {"predator",       3, 2, 240, 1024, 768},
+    {"bigger-fish",    4, 3, 240, 1024, 768},
+    {"baby-predators", 5, 5, 240, 1024, 768},
+    {"school-640",     1, 0, 180, 640, 480},
+    {"predator-640",   3, 2, 240, 640, 480},
+};
+
+struct CaseReport {
+    bool passed = true;
+    bool missingGolden = false;
+    float badFraction = 0.0f;
+    float worst = 0.0f;
+    double cpuAvgMs = 0.0, cpuP95Ms = 0.0;
+    double gpuAvgMs = -1.0; // -1 without timer queries
+};
+
+// The table with only `level` in it, so a case starts right at that level.
+LevelTable SingleLevel(const LevelTable& table, int level) {
+    LevelTable single;
+    single.playerSpeed = table.playerSpeed;
+    LevelDef def = table.levels[level];
+    single.spawns.assign(table.spawns.begin() + def.spawnBegin, table.spawns.begin() + def.spawnBegin + def.spawnCount);
+    def.spawnBegin = 0;
+    single.levels.push_back(def);
+    return single;
+}
+
+// Distance in YCbCr with chroma weighted down, the eye notices brightness
+// changes long before small hue shifts. 0 is the same color, 1 black
+// against white.
+float PixelDistance(const unsigned char* a, const unsigned char* b) {
+    float dr = (a[0] - b[0]) / 255.0f;
+    float dg = (a[1] - b[1]) / 255.0f;
+    float db = (a[2] - b[2]) / 255.0f;
+    float dy = 0.299f * dr + 0.587f * dg + 0.114f * db;
+    float dcb = -0.169f * dr - 0.331f * dg + 0.5f * db;
+    float dcr = 0.5f * dr - 0.419f * dg - 0.081f * db;
+    return std::sqrt(dy * dy + 0.25f * (dcb * dcb + dcr * dcr));
+}
+
+// A pixel only counts as different when nothing in the 3x3 block around it
+// in the golden is close, so edges that moved by one pixel (antialiasing,
+// driver rounding) pass and real changes don't. Bad pixels go red in `diff`.
+CaseReport Compare(const ofPixels& actual, const ofPixels& golden, float tolerance, ofPixels& diff) {
+    CaseReport report;
+    const int w = int(actual.getWidth());
+    const int h = int(actual.getHeight());
+    const size_t ca = actual.getNumChannels();
+    const size_t cg = golden.getNumChannels();
+    const unsigned char* a = actual.getData();
+    const unsigned char* g = golden.getData();
+    diff.allocate(w, h, OF_IMAGE_COLOR);
+
+    size_t bad = 0;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const unsigned char* pa = a + (size_t(y) * w + x) * ca;
+            float best = PixelDistance(pa, g + (size_t(y) * w + x) * cg);
+            for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, h - 1) && best > tolerance; ++ny) {
+                for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, w - 1); ++nx) {
+                    best = std::min(best, PixelDistance(pa, g + (size_t(ny) * w + nx) * cg));
+                }
+            }
+            report.worst = std::max(report.worst, best);
+            if (best > tolerance) {
+                ++bad;
+                diff.setColor(x, y, ofColor(255, 0, 0));
+            } else {
+                unsigned char gray = (pa[0] + pa[1] + pa[2]) / 9; // dimmed so the red stands out
+                diff.setColor(x, y, ofColor(gray, gray, gray));
+            }
+        }
+    }
+    report.badFraction = w * h > 0 ? float(bad) / float(w * h) : 0.0f;
+    return report;
+}
+
+bool HasTimerQuery() {
+#ifdef TARGET_OPENGLES
+    return false;
+#else
+    return GLEW_ARB_timer_query || GLEW_VERSION_3_3;
+#endif
+}
+
+// Runs every case from its first draw() call, where the GL context is
+// ready, then closes the window.
+class GoldenFrameApp : public ofBaseApp {
+    public:
+        explicit GoldenFrameApp(GoldenOptions options) : m_options(std::move(options)) {}
+
+        void draw() override {
+            if (m_done) { return; }
+            m_done = true;
+            m_result = this->runAll();
+            ofExit(m_result);
+        }
+
+        int GetResult() const { return m_result; }
+
+    private:
+        int runAll() {
+            m_levels = LevelTable::Defaults();
+            // same as ofApp::setup, before the sprite manager looks the
+            // animations up, so fish and crabs go through the batch shader
+            std::string animationError;
+            if (!AnimationTable::LoadFromXml(ofToDataPath("animations.xml", true), animationError)) {
+                std::cout << "[golden] no sprite animations: " << animationError << std::endl;
+                return 1;
+            }
+            AnimationTable::LoadTextures();
+            m_sprites = std::make_shared<AquariumSpriteManager>();
+            std::string dir = ofToDataPath(m_options.directory, true);
+            ofDirectory::createDirectory(dir + "/out", false, true);
+
+            int failed = 0;
+            for (const GoldenCase& c : Cases) {
+                CaseReport report = this->runCase(c, dir);
+                char line[200];
+                char gpu[32] = "n/a";
+                if (report.gpuAvgMs >= 0.0) { std::snprintf(gpu, sizeof(gpu), "%6.3f ms", report.gpuAvgMs); }
+                const char* verdict = m_options.update ? "written"
+                                    : report.missingGolden ? "NO GOLDEN"
+                                    : report.passed ? "ok" : "FAIL";
+                std::snprintf(line, sizeof(line), "%-15s %4dx%-4d %-9s %6.3f%% differ (worst %.3f)  cpu %6.3f ms (p95 %6.3f)  gpu %s",
+                              c.name, c.width, c.height, verdict, report.badFraction * 100.0f, report.worst,
+                              report.cpuAvgMs, report.cpuP95Ms, gpu);
+                std::cout << "[golden] " << line << std::endl;
+                if (!report.passed) { ++failed; }
+            }
+            if (failed > 0) {
+                std::cout << "[golden] " << failed << " case(s) failed, see " << dir << "/out" << std::endl;
+            }
+            return failed > 0 ? 1 : 0;
+        }
+
+        CaseReport runCase(const GoldenCase& c, const std::string& dir) {
+            CaseReport report;
+
+            // same setup as ofApp, seeded
+            auto aquarium = std::make_shared<Aquarium>(WorldWidth, WorldHeight, m_sprites);
+            aquarium->seed(c.seed);
+            aquarium->setLevelTable(SingleLevel(m_levels, c.level));
+            aquarium->Repopulate();
+            auto player = std::make_shared<PlayerCreature>(WorldWidth / 2 - 50, WorldHeight / 2 - 50, m_levels.playerSpeed,
+                                                           m_sprites->GetPlayerSprite(PlayerType::Pirahna));
+            AquariumGameScene scene(player, aquarium, c.name);
+            for (int t = 0; t < c.ticks; ++t) {
+                float angle = t / 60.0f; // a slow circle, so the player shows up facing both ways
+                player->setDirection(std::cos(angle), std::sin(angle));
+                scene.Simulate();
+            }
+
+            ofImage background;
+            background.load("background.png");
+            WorldView view;
+            view.SetTargetSize(c.width, c.height);
+
+            ofFboSettings settings;
+            settings.width = c.width;
+            settings.height = c.height;
+            settings.internalformat = GL_RGBA;
+            ofFbo fbo;
+            fbo.allocate(settings);
+            auto drawFrame = [&]() {
+                fbo.begin();
+                ofClear(ofColor::blue);
+                view.Begin();
+                background.draw(0, 0, WorldWidth, WorldHeight);
+                scene.Draw();
+                view.End();
+                fbo.end();
+            };
+
+            drawFrame();
+            ofPixels actual;
+            fbo.readToPixels(actual);
+
+            std::string goldenPath = dir + "/" + c.name + ".png";
+            if (m_options.update) {
+                ofSaveImage(actual, goldenPath);
+            } else {
+                ofPixels golden;
+                if (!ofLoadImage(golden, goldenPath)) {
+                    report.passed = false;
+                    report.missingGolden = true;
+                } else if (golden.getWidth() != actual.getWidth() || golden.getHeight() != actual.getHeight()) {
+                    report.passed = false;
+                    report.badFraction = 1.0f;
+                } else {
+                    ofPixels diff;
+                    CaseReport compared = Compare(actual, golden, m_options.pixelTolerance, diff);
+                    report.badFraction = compared.badFraction;
+                    report.worst = compared.worst;
+                    report.passed = compared.badFraction <= m_options.maxBadPixels;
+                    if (!report.passed) {
+                        ofSaveImage(diff, dir + "/out/" + c.name + "-diff.png");
+                    }
+                }
+                if (!report.passed) {
+                    ofSaveImage(actual, dir + "/out/" + c.name + "-actual.png");
+                }
+            }
+
+            this->timeCase(drawFrame, report);
+            return report;
+        }
+
+        // glFinish between frames keeps them from overlapping and is not
+        // counted in either number.
+        template <typename DrawFn>
+        void timeCase(DrawFn& drawFrame, CaseReport& report) {
+            const int frames = std::max(m_options.timingFrames, 1);
+            const bool gpuTimer = HasTimerQuery();
+            GLuint query = 0;
+            if (gpuTimer) { glGenQueries(1, &query); }
+
+            std::vector<double> cpuMs;
+            cpuMs.reserve(frames);
+            double gpuMs = 0.0;
+            glFinish();
+            for (int i = 0; i < frames; ++i) {
+                if (gpuTimer) { glBeginQuery(GL_TIME_ELAPSED, query); }
+                auto start = std::chrono::steady_clock::now();
+                drawFrame();
+                cpuMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                if (gpuTimer) { glEndQuery(GL_TIME_ELAPSED); }
+                glFinish();
+                if (gpuTimer) {
+                    GLuint64 nanos = 0;
+                    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanos);
+                    gpuMs += nanos / 1.0e6;
+                }
+            }
+            if (gpuTimer) {
+                glDeleteQueries(1, &query);
+                report.gpuAvgMs = gpuMs / frames;
+            }
+
+            double total = 0.0;
+            for (double ms : cpuMs) { total += ms; }
+            report.cpuAvgMs = total / frames;
+            std::sort(cpuMs.begin(), cpuMs.end());
+            report.cpuP95Ms = cpuMs[std::min(size_t(frames * 0.95), cpuMs.size() - 1)];
+        }
+
+        GoldenOptions m_options;
+        LevelTable m_levels;
+        std::shared_ptr<AquariumSpriteManager> m_sprites;
+        bool m_done = false;
+        int m_result = 1;
+};
+
+}
+
+int RunGoldenFrames(const GoldenOptions& options) {
+    // the window is never shown, it only provides the GL context
+    ofGLFWWindowSettings settings;
+    settings.setSize(320, 240);
+    settings.visible = false;
+    settings.resizable = false;
+    auto window = ofCreateWindow(settings);
+
+    auto app = std::make_shared<GoldenFrameApp>(options);
+    ofRunApp(window, app);
+    ofRunMainLoop();
+    return app->GetResult();
+}
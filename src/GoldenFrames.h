@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+struct GoldenOptions {
+    bool update = false;             // write the goldens instead of checking them
+    int timingFrames = 120;          // extra draws per case for the timings
+    float pixelTolerance = 0.06f;    // perceptual distance, 0 same .. 1 black vs white
+    float maxBadPixels = 0.002f;     // fraction of the frame allowed to differ
+    std::string directory = "golden"; // under bin/data
+};
+
+// Renders seeded aquarium states into fbos of fixed resolutions from a
+// hidden window, reads the pixels back and compares them with the stored
+// golden PNGs, then redraws each case to time it. CPU time is what the draw
+// calls cost to submit, GPU time comes from timer queries. Neither includes
+// vsync since nothing is presented.
+//
+// Run with `./bin/Aquarium --golden` to check and `--golden update` after an
+// intended visual change. Goldens depend on the GPU and driver a little, the
+// tolerance covers antialiasing noise but not a different machine's fonts.
+// Failing cases leave <name>-actual.png and <name>-diff.png in golden/out.
+int RunGoldenFrames(const GoldenOptions& options);
@@ -0,0 +1,157 @@
+#include "InputState.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "ofMain.h"
+#if !defined(TARGET_OPENGLES) && !defined(TARGET_EMSCRIPTEN)
+#include <GLFW/glfw3.h>
+#define AQUARIUM_HAS_GAMEPAD
+#endif
+
+namespace {
+
+const float StickDeadZone = 0.25f;
+
+}
+
+ActionMap::ActionMap() {
+    bool ok = true;
+    ok = this->Bind(InputAction::MoveLeft, OF_KEY_LEFT) && ok;
+    ok = this->Bind(InputAction::MoveLeft, 'a') && ok;
+    ok = this->Bind(InputAction::MoveRight, OF_KEY_RIGHT) && ok;
+    ok = this->Bind(InputAction::MoveRight, 'd') && ok;
+    ok = this->Bind(InputAction::MoveUp, OF_KEY_UP) && ok;
+    ok = this->Bind(InputAction::MoveUp, 'w') && ok;
+    ok = this->Bind(InputAction::MoveDown, OF_KEY_DOWN) && ok;
+    ok = this->Bind(InputAction::MoveDown, 's') && ok;
+    ok = this->Bind(InputAction::Boost, ' ') && ok;
+#ifdef AQUARIUM_HAS_GAMEPAD
+    ok = this->BindButton(InputAction::MoveLeft, GLFW_GAMEPAD_BUTTON_DPAD_LEFT) && ok;
+    ok = this->BindButton(InputAction::MoveRight, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT) && ok;
+    ok = this->BindButton(InputAction::MoveUp, GLFW_GAMEPAD_BUTTON_DPAD_UP) && ok;
+    ok = this->BindButton(InputAction::MoveDown, GLFW_GAMEPAD_BUTTON_DPAD_DOWN) && ok;
+    ok = this->BindButton(InputAction::Boost, GLFW_GAMEPAD_BUTTON_A) && ok;
+    ok = this->BindButton(InputAction::Boost, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER) && ok;
+#endif
+    assert(ok && "a default binding did not fit");
+    (void)ok;
+}
+
+bool ActionMap::Bind(InputAction action, int key) {
+    Bindings& bindings = m_bindings[size_t(action)];
+    if (bindings.keyCount == MaxBindings || key < 0 || key >= InputKeyCount) { return false; }
+    bindings.keys[bindings.keyCount++] = key;
+    return true;
+}
+
+bool ActionMap::BindButton(InputAction action, int gamepadButton) {
+    Bindings& bindings = m_bindings[size_t(action)];
+    if (bindings.buttonCount == MaxBindings || gamepadButton < 0 || gamepadButton >= 32) { return false; }
+    bindings.buttons[bindings.buttonCount++] = gamepadButton;
+    return true;
+}
+
+void ActionMap::Clear(InputAction action) {
+    m_bindings[size_t(action)].keyCount = 0;
+    m_bindings[size_t(action)].buttonCount = 0;
+}
+
+ActionBits ActionMap::Resolve(const KeyBits& keys, uint32_t buttons) const {
+    ActionBits actions = 0;
+    for (size_t a = 0; a < size_t(InputAction::Count); ++a) {
+        const Bindings& bindings = m_bindings[a];
+        bool down = false;
+        for (int i = 0; i < bindings.keyCount && !down; ++i) { down = keys[size_t(bindings.keys[i])]; }
+        for (int i = 0; i < bindings.buttonCount && !down; ++i) { down = (buttons >> bindings.buttons[i]) & 1u; }
+        if (down) { actions |= ActionBits(1u << a); }
+    }
+    return actions;
+}
+
+void InputState::KeyPressed(int key, uint64_t micros) {
+    if (key < 0 || key >= InputKeyCount || m_keys[size_t(key)]) { return; } // ignore key repeat
+    m_keys.set(size_t(key));
+    this->publish(micros);
+}
+
+void InputState::KeyReleased(int key, uint64_t micros) {
+    if (key < 0 || key >= InputKeyCount) { return; }
+    m_keys.reset(size_t(key));
+    this->publish(micros);
+}
+
+void InputState::PollGamepad(uint64_t micros) {
+    uint32_t buttons = 0;
+    float x = 0.0f, y = 0.0f;
+#ifdef AQUARIUM_HAS_GAMEPAD
+    for (int pad = GLFW_JOYSTICK_1; pad <= GLFW_JOYSTICK_LAST; ++pad) {
+        GLFWgamepadstate state;
+        if (!glfwJoystickIsGamepad(pad) || !glfwGetGamepadState(pad, &state)) { continue; }
+        for (int b = 0; b < int(sizeof(state.buttons)); ++b) {
+            if (state.buttons[b] == GLFW_PRESS) { buttons |= 1u << b; }
+        }
+        x = state.axes[GLFW_GAMEPAD_AXIS_LEFT_X];
+        y = state.axes[GLFW_GAMEPAD_AXIS_LEFT_Y];
+        if (std::sqrt(x * x + y * y) < StickDeadZone) { x = y = 0.0f; }
+        break; // first pad only
+    }
+#endif
+    // a sample the queue dropped gets another go here, once per frame
+    if (buttons == m_padButtons && x == m_padX && y == m_padY && !m_resend) { return; }
+    m_padButtons = buttons;
+    m_padX = x;
+    m_padY = y;
+    this->publish(micros);
+}
+
+void InputState::publish(uint64_t micros) {
+    InputSample sample;
+    sample.micros = micros;
+    sample.actions = m_actionMap.Resolve(m_keys, m_padButtons);
+    if (m_padX != 0.0f || m_padY != 0.0f) {
+        sample.moveX = m_padX;
+        sample.moveY = m_padY;
+    } else {
+        sample.moveX = float(sample.Has(InputAction::MoveRight)) - float(sample.Has(InputAction::MoveLeft));
+        sample.moveY = float(sample.Has(InputAction::MoveDown)) - float(sample.Has(InputAction::MoveUp));
+    }
+    // keys that aren't bound to anything don't make a sample
+    if (sample.actions == m_published.actions && sample.moveX == m_published.moveX && sample.moveY == m_published.moveY) {
+        return;
+    }
+    // only remember it once it's actually in the queue, otherwise the next
+    // publish would think the update thread already has it
+    m_resend = !m_samples.Push(sample);
+    if (m_resend) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_published = sample;
+}
+
+const InputSample& InputState::Consume(uint64_t nowMicros) {
+    InputSample sample;
+    while (m_samples.Pop(sample)) {
+        uint64_t latency = nowMicros > sample.micros ? nowMicros - sample.micros : 0;
+        ++m_latencySamples;
+        m_latencyTotal += latency;
+        m_latencyMax = std::max(m_latencyMax, latency);
+        m_current = sample;
+    }
+    return m_current;
+}
+
+InputState::Latency InputState::GetLatency() const {
+    Latency latency;
+    latency.samples = m_latencySamples;
+    latency.avgMs = m_latencySamples ? m_latencyTotal / 1000.0 / m_latencySamples : 0.0;
+    latency.maxMs = m_latencyMax / 1000.0;
+    latency.dropped = m_dropped.load(std::memory_order_relaxed);
+    return latency;
+}
+
+void InputState::ResetLatency() {
+    m_latencySamples = 0;
+    m_latencyTotal = 0;
+    m_latencyMax = 0;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include "SpscQueue.h"
+
+enum class InputAction : uint8_t {
+    MoveLeft,
+    MoveRight,
+    MoveUp,
+    MoveDown,
+    Boost,
+    Count
+};
+
+// OF key codes are 16 bit: plain keys are their character, the special
+// keys (arrows, F1..F12...) sit at 0xE000 and up. 8 KB of bits covers
+// every one of them.
+constexpr int InputKeyCount = 0x10000;
+using KeyBits = std::bitset<InputKeyCount>;
+
+// One bit per InputAction.
+using ActionBits = uint8_t;
+constexpr ActionBits ActionBit(InputAction action) { return ActionBits(1u << unsigned(action)); }
+
+// What the player is asking for at one instant. The move axes are -1..1:
+// keys give the 8 directions, a stick anything in between.
+struct InputSample {
+    uint64_t micros = 0; // ofGetElapsedTimeMicros() when it happened
+    ActionBits actions = 0;
+    float moveX = 0.0f;
+    float moveY = 0.0f;
+    bool Has(InputAction action) const { return (actions & ActionBit(action)) != 0; }
+};
+
+// Keys and gamepad buttons bound to each action. An action can have a few of
+// each, rebinding is Clear + Bind.
+class ActionMap {
+    public:
+        static constexpr int MaxBindings = 4;
+
+        // arrows/WASD move and space boosts; d-pad or left stick and A/RB on a pad
+        ActionMap();
+        // False when the action already has MaxBindings keys (or buttons).
+        bool Bind(InputAction action, int key);
+        bool BindButton(InputAction action, int gamepadButton);
+        void Clear(InputAction action);
+
+        ActionBits Resolve(const KeyBits& keys, uint32_t buttons) const;
+
+    private:
+        struct Bindings {
+            int keys[MaxBindings];
+            int keyCount = 0;
+            int buttons[MaxBindings];
+            int buttonCount = 0;
+        };
+        Bindings m_bindings[size_t(InputAction::Count)];
+};
+
+// Flat input state. Key callbacks and the gamepad poll update one bitset and
+// push a timestamped sample whenever the resolved actions change; the
+// simulation side drains the samples once per tick. Producer and consumer
+// may be different threads. The time from a sample to the tick that
+// consumed it is kept as the key-to-move latency.
+class InputState {
+    public:
+        // Producer side.
+        void KeyPressed(int key, uint64_t micros);
+        void KeyReleased(int key, uint64_t micros);
+        // Reads the first connected gamepad. Once a frame is plenty.
+        void PollGamepad(uint64_t micros);
+        bool IsKeyDown(int key) const { return key >= 0 && key < InputKeyCount && m_keys[size_t(key)]; }
+        ActionMap& GetActionMap() { return m_actionMap; }
+
+        // Consumer side. Applies every pending sample and returns the latest.
+        const InputSample& Consume(uint64_t nowMicros);
+        const InputSample& GetCurrent() const { return m_current; }
+
+        struct Latency {
+            uint64_t samples = 0;
+            double avgMs = 0.0;
+            double maxMs = 0.0;
+            uint64_t dropped = 0; // queue was full, the sample is sent again on the next poll
+        };
+        Latency GetLatency() const;
+        void ResetLatency();
+
+    private:
+        void publish(uint64_t micros);
+
+        ActionMap m_actionMap;
+        KeyBits m_keys;
+        uint32_t m_padButtons = 0; // bit n is GLFW gamepad button n
+        float m_padX = 0.0f;
+        float m_padY = 0.0f;
+        InputSample m_published; // last sample that made it into the queue
+        bool m_resend = false;
+        std::atomic<uint64_t> m_dropped{0};
+
+        SpscQueue<InputSample, 256> m_samples;
+
+        InputSample m_current;
+        uint64_t m_latencySamples = 0;
+        uint64_t m_latencyTotal = 0;
+        uint64_t m_latencyMax = 0;
+};
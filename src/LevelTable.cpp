@@ -0,0 +1,134 @@
+#include "LevelTable.h"
+#include "CreatureArchetypes.h"
+#include "ofMain.h"
+#include <filesystem>
+
+namespace {
+
+int AttributeInt(const ofXml& node, const std::string& name, int fallback) {
+    auto attribute = node.getAttribute(name);
+    return attribute ? attribute.getIntValue() : fallback;
+}
+
+float AttributeFloat(const ofXml& node, const std::string& name, float fallback) {
+    auto attribute = node.getAttribute(name);
+    return attribute ? attribute.getFloatValue() : fallback;
+}
+
+long long WriteTime(const std::string& path) {
+    std::error_code ec;
+    auto stamp = std::filesystem::last_write_time(path, ec);
+    if (ec) { return 0; }
+    return static_cast<long long>(stamp.time_since_epoch().count());
+}
+
+}
+
+const LevelSpawnDef* LevelTable::FindSpawn(int level, AquariumCreatureType type) const {
+    if (level < 0 || size_t(level) >= levels.size()) { return nullptr; }
+    const LevelDef& def = levels[level];
+    for (int i = def.spawnBegin; i < def.spawnBegin + def.spawnCount; ++i) {
+        if (spawns[i].type == type) { return &spawns[i]; }
+    }
+    return nullptr;
+}
+
+LevelTable LevelTable::Defaults() {
+    using T = AquariumCreatureType;
+    LevelTable table;
+    auto addLevel = [&table](int target, std::initializer_list<LevelSpawnDef> spawns) {
+        LevelDef def;
+        def.targetScore = target;
+        def.powerUpChance = 0.002f; // once every ~8s on average
+        def.powerUpCooldownFrames = 10 * 60;
+        def.spawnBegin = static_cast<int>(table.spawns.size());
+        def.spawnCount = static_cast<int>(spawns.size());
+        table.spawns.insert(table.spawns.end(), spawns);
+        table.levels.push_back(def);
+    };
+    // speeds are the archetype defaults
+    auto spawn = [](AquariumCreatureType type, int count) {
+        return LevelSpawnDef{type, count, GetArchetype(type).minSpeed, GetArchetype(type).maxSpeed};
+    };
+    addLevel(10, { spawn(T::NPCreature, 10) });
+    addLevel(15, { spawn(T::Crab, 3), spawn(T::NPCreature, 20) });
+    addLevel(15, { spawn(T::Predator, 1), spawn(T::NPCreature, 30) });
+    addLevel(20, { spawn(T::NPCreature, 30), spawn(T::BiggerFish, 5) });
+    addLevel(20, { spawn(T::Predator, 1), spawn(T::Crab, 2), spawn(T::NPCreature, 30) });
+    addLevel(25, { spawn(T::BabyPredator, 4), spawn(T::NPCreature, 30) });
+    return table;
+}
+
+bool LevelTable::LoadFromXml(const std::string& path, LevelTable& out, std::string& error) {
+    ofXml xml;
+    if (!xml.load(path)) {
+        error = "could not load " + path;
+        return false;
+    }
+    ofXml root = xml.getChild("group");
+    ofXml levelsNode = root.getChild("levels");
+    if (!levelsNode) {
+        error = "no <levels> block in " + path;
+        return false;
+    }
+
+    LevelTable table;
+    if (ofXml speed = root.getChild("player_speed")) {
+        table.playerSpeed = std::max(1, speed.getIntValue());
+    }
+
+    for (const ofXml& levelNode : levelsNode.getChildren("level")) {
+        LevelDef def;
+        def.targetScore = std::max(1, AttributeInt(levelNode, "target", 10)); // 0 would finish the level every tick
+        def.powerUpChance = AttributeFloat(levelNode, "powerup_chance", 0.002f);
+        def.powerUpCooldownFrames = AttributeInt(levelNode, "powerup_cooldown", 10 * 60);
+        def.spawnBegin = static_cast<int>(table.spawns.size());
+
+        for (const ofXml& spawnNode : levelNode.getChildren("spawn")) {
+            LevelSpawnDef spawn;
+            std::string typeName = spawnNode.getAttribute("type").getValue();
+            if (!AquariumCreatureTypeFromString(typeName, spawn.type)) {
+                error = "unknown creature type '" + typeName + "' in level " + std::to_string(table.levels.size());
+                return false;
+            }
+            spawn.count = std::max(0, AttributeInt(spawnNode, "count", 0));
+            spawn.minSpeed = std::max(0, AttributeInt(spawnNode, "min_speed", GetArchetype(spawn.type).minSpeed));
+            spawn.maxSpeed = std::max(spawn.minSpeed, AttributeInt(spawnNode, "max_speed", std::max(spawn.minSpeed, GetArchetype(spawn.type).maxSpeed)));
+            table.spawns.push_back(spawn);
+        }
+        def.spawnCount = static_cast<int>(table.spawns.size()) - def.spawnBegin;
+        table.levels.push_back(def);
+    }
+
+    if (table.levels.empty()) {
+        error = "<levels> in " + path + " has no <level> entries";
+        return false;
+    }
+    out = std::move(table);
+    return true;
+}
+
+// LevelTableWatcher
+
+LevelTableWatcher::LevelTableWatcher(std::string path, int pollIntervalFrames)
+: m_path(std::move(path)), m_pollIntervalFrames(pollIntervalFrames) {
+    m_lastWriteTime = WriteTime(m_path);
+}
+
+bool LevelTableWatcher::Poll(LevelTable& out) {
+    // a stat per frame is cheap, but there is no point doing it 60 times a second
+    if (m_framesUntilPoll-- > 0) { return false; }
+    m_framesUntilPoll = m_pollIntervalFrames;
+
+    long long stamp = WriteTime(m_path);
+    if (stamp == 0 || stamp == m_lastWriteTime) { return false; }
+    m_lastWriteTime = stamp;
+
+    std::string error;
+    if (!LevelTable::LoadFromXml(m_path, out, error)) {
+        ofLogError() << "Level reload failed, keeping the current levels: " << error;
+        return false;
+    }
+    ofLogNotice() << "Reloaded " << out.levels.size() << " levels from " << m_path;
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "CreatureTypes.h"
+
+// One creature type a level keeps alive, and the speed range it spawns with.
+struct LevelSpawnDef {
+    AquariumCreatureType type = AquariumCreatureType::NPCreature;
+    int count = 0;
+    int minSpeed = 1;
+    int maxSpeed = 1;
+};
+
+// Level rows reference their spawns as a [spawnBegin, spawnBegin+spawnCount)
+// slice of LevelTable::spawns, so the whole table is two flat arrays.
+struct LevelDef {
+    int targetScore = 0;
+    float powerUpChance = 0.0f;     // chance per aquarium tick once the cooldown is over
+    int powerUpCooldownFrames = 0;
+    int spawnBegin = 0;
+    int spawnCount = 0;
+};
+
+struct LevelTable {
+    int playerSpeed = 5;
+    std::vector<LevelDef> levels;
+    std::vector<LevelSpawnDef> spawns;
+
+    bool empty() const { return levels.empty(); }
+    const LevelSpawnDef* FindSpawn(int level, AquariumCreatureType type) const;
+
+    // Built-in levels, used when settings.xml is missing or broken.
+    static LevelTable Defaults();
+    // Parses the <levels> block of settings.xml. On failure `out` is left
+    // untouched and `error` says why.
+    static bool LoadFromXml(const std::string& path, LevelTable& out, std::string& error);
+};
+
+// Polls a file's modification time and reloads the level table when it
+// changes. Meant to be polled from the main loop between ticks.
+class LevelTableWatcher {
+    public:
+        LevelTableWatcher(std::string path, int pollIntervalFrames = 30);
+        // Returns true when `out` was replaced by a freshly parsed table.
+        bool Poll(LevelTable& out);
+
+    private:
+        std::string m_path;
+        int m_pollIntervalFrames;
+        int m_framesUntilPoll = 0;
+        long long m_lastWriteTime = 0;
+};
@@ -0,0 +1,129 @@
+#include "MemoryReport.h"
+#include "Aquarium.h"
+#include "CreatureRecords.h"
+#include <cstdio>
+
+namespace {
+
+AquariumCreatureType TypeOf(const Creature& creature) {
+    if (auto npc = dynamic_cast<const NPCreature*>(&creature)) {
+        return npc->GetType();
+    }
+    return AquariumCreatureType::SpeedPowerUp;
+}
+
+std::string Bytes(size_t bytes) {
+    char text[32];
+    if (bytes >= 1024 * 1024) {
+        std::snprintf(text, sizeof(text), "%.1f MB", bytes / (1024.0 * 1024.0));
+    } else if (bytes >= 1024) {
+        std::snprintf(text, sizeof(text), "%.1f KB", bytes / 1024.0);
+    } else {
+        std::snprintf(text, sizeof(text), "%zu B", bytes);
+    }
+    return text;
+}
+
+}
+
+size_t AquariumMemory::ObjectSize(AquariumCreatureType type) {
+    switch (GetArchetype(type).kind) {
+        case CreatureKind::Swimmer:
+        case CreatureKind::Walker:
+            // every ArchetypeCreature<T> has the same layout
+            return sizeof(BaseFish);
+        case CreatureKind::Predator:
+            return sizeof(Predator);
+        case CreatureKind::PowerUp:
+            return sizeof(SpeedPowerUp);
+        case CreatureKind::PredatorPart:
+            break;
+    }
+    return 0;
+}
+
+AquariumMemory::Report AquariumMemory::Measure(const Aquarium& aquarium) {
+    Report report;
+    report.width = aquarium.m_width;
+    report.height = aquarium.m_height;
+
+    auto count = [&](const Creature& creature, bool pooled) {
+        AquariumCreatureType type = TypeOf(creature);
+        TypeRow& row = report.types[size_t(type)];
+        ++(pooled ? row.pooled : row.live);
+        row.objectBytes += ObjectSize(type);
+        row.handleBytes += sizeof(std::shared_ptr<Creature>) + ControlBlockBytes;
+        if (auto predator = dynamic_cast<const Predator*>(&creature)) {
+            row.bodyBytes += predator->getSegments().size() * 2 * sizeof(float);
+        }
+    };
+    for (const auto& creature : aquarium.m_creatures) {
+        count(*creature, false);
+    }
+    for (const auto& pool : aquarium.m_creaturePool) {
+        for (const auto& creature : pool) {
+            count(*creature, true);
+        }
+        // the slot is already counted with the creature
+        report.listBytes += (pool.capacity() - pool.size()) * sizeof(std::shared_ptr<Creature>);
+    }
+    report.listBytes += (aquarium.m_creatures.capacity() - aquarium.m_creatures.size()) * sizeof(std::shared_ptr<Creature>);
+    report.listBytes += aquarium.m_next_creatures.capacity() * sizeof(std::shared_ptr<Creature>);
+    report.listBytes += aquarium.m_schoolingFish.capacity() * sizeof(NPCreature*);
+    report.listBytes += (aquarium.m_predators.capacity() + aquarium.m_movers.capacity()) * sizeof(Creature*);
+    report.listBytes += aquarium.m_drawList.capacity() * sizeof(AquariumDrawItem);
+    report.listBytes += aquarium.m_toRespawn.capacity() * sizeof(AquariumCreatureType);
+
+    report.chainPoolBytes = aquarium.m_chainPool->GetBytes();
+    report.schoolingBytes = aquarium.m_schooling.GetBytes();
+    report.spriteCount = SpriteTable::GetCount();
+    report.spriteBytes = SpriteTable::GetBytes();
+    return report;
+}
+
+size_t AquariumMemory::Report::CreatureCount() const {
+    size_t total = 0;
+    for (const TypeRow& row : types) { total += row.live + row.pooled; }
+    return total;
+}
+
+size_t AquariumMemory::Report::CreatureBytes() const {
+    size_t total = 0;
+    for (const TypeRow& row : types) { total += row.Total(); }
+    return total;
+}
+
+size_t AquariumMemory::Report::AquariumBytes() const {
+    // the bodies live in the chain pool, don't count them twice
+    size_t bodies = 0;
+    for (const TypeRow& row : types) { bodies += row.bodyBytes; }
+    return this->CreatureBytes() - bodies + listBytes + chainPoolBytes + schoolingBytes;
+}
+
+void AquariumMemory::Print(const Report& report, std::ostream& out) {
+    char line[160];
+    out << "[memory] " << report.width << "x" << report.height << " aquarium, " << report.CreatureCount() << " creatures" << std::endl;
+    std::snprintf(line, sizeof(line), "  %-14s %6s %6s %7s %7s %7s %6s %10s", "type", "live", "pooled", "object", "handle",
+                  "body", "each", "total");
+    out << line << std::endl;
+
+    size_t simple = 0;
+    for (const CreatureArchetype& archetype : CreatureArchetypes) {
+        const TypeRow& row = report.types[size_t(archetype.type)];
+        size_t n = row.live + row.pooled;
+        if (n == 0) { continue; }
+        if (archetype.kind == CreatureKind::Swimmer || archetype.kind == CreatureKind::Walker) { simple += n; }
+        std::snprintf(line, sizeof(line), "  %-14s %6zu %6zu %7zu %7zu %7zu %6zu %10s", archetype.name, row.live, row.pooled,
+                      row.objectBytes / n, row.handleBytes / n, row.bodyBytes / n, row.Total() / n, Bytes(row.Total()).c_str());
+        out << line << std::endl;
+    }
+
+    out << "  creatures      : " << Bytes(report.CreatureBytes()) << std::endl;
+    out << "  creature lists : " << Bytes(report.listBytes) << std::endl;
+    out << "  predator chains: " << Bytes(report.chainPoolBytes) << std::endl;
+    out << "  schooling      : " << Bytes(report.schoolingBytes) << std::endl;
+    out << "  aquarium total : " << Bytes(report.AquariumBytes()) << std::endl;
+    out << "  sprites        : " << report.spriteCount << " shared, " << Bytes(report.spriteBytes) << std::endl;
+    out << "  compact record : " << sizeof(CreatureRecord) << " B per fish or crab, the " << simple << " here would take "
+        << Bytes(simple * sizeof(CreatureRecord)) << std::endl;
+}
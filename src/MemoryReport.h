@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include "CreatureTypes.h"
+
+class Aquarium;
+
+// Where an aquarium's memory goes, per creature type and in total. Object
+// sizes are sizeof, containers count their capacity; allocator overhead
+// isn't counted. Print it with F10 in the game or `--bench memory`.
+class AquariumMemory {
+    public:
+        struct TypeRow {
+            size_t live = 0;
+            size_t pooled = 0;       // parked for snapshot loads
+            size_t objectBytes = 0;  // the creature objects themselves
+            size_t handleBytes = 0;  // shared_ptr slots plus make_shared control blocks
+            size_t bodyBytes = 0;    // predator segments in the chain pool
+            size_t Total() const { return objectBytes + handleBytes + bodyBytes; }
+        };
+
+        struct Report {
+            int width = 0;
+            int height = 0;
+            TypeRow types[size_t(AquariumCreatureType::Count)];
+            size_t listBytes = 0;       // creature vectors and pools, capacity
+            size_t chainPoolBytes = 0;  // whole pool, including free space
+            size_t schoolingBytes = 0;
+            size_t spriteCount = 0;     // shared by every aquarium in the process
+            size_t spriteBytes = 0;
+
+            size_t CreatureCount() const;
+            size_t CreatureBytes() const;
+            // Without the sprites, those don't grow with the aquarium.
+            size_t AquariumBytes() const;
+        };
+
+        static Report Measure(const Aquarium& aquarium);
+        static void Print(const Report& report, std::ostream& out);
+
+        // sizeof the class a type is built as.
+        static size_t ObjectSize(AquariumCreatureType type);
+        // What make_shared adds next to the object: use/weak counts and a vtable.
+        static constexpr size_t ControlBlockBytes = 16;
+};
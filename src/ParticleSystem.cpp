@@ -0,0 +1,164 @@
+#include "ParticleSystem.h"
+
+namespace {
+
+struct EffectDef {
+    int count;
+    float speedMin, speedMax;   // px per second
+    float lifeMin, lifeMax;     // seconds
+    float sizeMin, sizeMax;     // point size in px
+    float rise;                 // vertical acceleration, negative floats up
+    float r, g, b;
+    float angle, spread;        // emission direction and cone, radians
+};
+
+const float Tau = 6.2831853f;
+const float Up = -Tau / 4;
+
+const EffectDef Effects[] = {
+    //  count  speed        life        size        rise    color              angle spread
+    {   1,     10,  30,     4.0f, 8.0f, 3,   9,     -25,    0.6f, 0.8f, 1.0f,  Up,   0.6f }, // Bubble
+    {  60,     40, 160,     0.4f, 1.0f, 3,   7,     -40,    1.0f, 0.9f, 0.6f,  0,    Tau  }, // Eat
+    {  80,     60, 220,     0.3f, 0.8f, 4,   8,       0,    1.0f, 0.2f, 0.2f,  0,    Tau  }, // Hurt
+    { 150,     80, 260,     0.6f, 1.4f, 3,  10,     -20,    0.3f, 1.0f, 0.5f,  0,    Tau  }, // PowerUp
+    {   4,      5,  25,     0.3f, 0.7f, 2,   5,     -30,    0.4f, 1.0f, 0.7f,  0,    Tau  }, // Trail
+};
+static_assert(sizeof(Effects) / sizeof(Effects[0]) == size_t(ParticleEffect::Count), "one EffectDef per ParticleEffect");
+
+const char* VertexShader = R"(
+#version 120
+attribute float pointSize;
+void main() {
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_PointSize = pointSize;
+    gl_FrontColor = gl_Color;
+}
+)";
+
+// soft round dot instead of a square point
+const char* FragmentShader = R"(
+#version 120
+void main() {
+    vec2 p = gl_PointCoord * 2.0 - 1.0;
+    float d = dot(p, p);
+    if (d > 1.0) discard;
+    gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * (1.0 - d));
+}
+)";
+
+}
+
+void ParticleSystem::allocate() {
+    for (std::vector<float>* field : {&m_x, &m_y, &m_vx, &m_vy, &m_age, &m_life, &m_size, &m_rise, &m_r, &m_g, &m_b, &m_sizes}) {
+        field->resize(m_capacity);
+    }
+    m_positions.resize(m_capacity * 2);
+    m_colors.resize(m_capacity);
+}
+
+void ParticleSystem::Emit(ParticleEffect effect, float x, float y, int count) {
+    if (m_x.empty()) { this->allocate(); }
+    const EffectDef& def = Effects[size_t(effect)];
+    if (count < 0) { count = def.count; }
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto lerp = [&](float lo, float hi) { return lo + (hi - lo) * unit(m_rng); };
+
+    for (int n = 0; n < count; ++n) {
+        if (m_count >= m_budget) {
+            m_dropped += size_t(count - n);
+            return;
+        }
+        size_t i = m_count++;
+        float angle = def.angle + (unit(m_rng) - 0.5f) * def.spread;
+        float speed = lerp(def.speedMin, def.speedMax);
+        m_x[i] = x;
+        m_y[i] = y;
+        m_vx[i] = std::cos(angle) * speed;
+        m_vy[i] = std::sin(angle) * speed;
+        m_age[i] = 0.0f;
+        m_life[i] = lerp(def.lifeMin, def.lifeMax);
+        m_size[i] = lerp(def.sizeMin, def.sizeMax);
+        m_rise[i] = def.rise;
+        m_r[i] = def.r;
+        m_g[i] = def.g;
+        m_b[i] = def.b;
+    }
+}
+
+void ParticleSystem::EmitAmbient(float dt, float width, float height) {
+    m_ambientCarry += bubblesPerSecond * dt;
+    std::uniform_real_distribution<float> across(0.0f, width);
+    while (m_ambientCarry >= 1.0f) {
+        this->Emit(ParticleEffect::Bubble, across(m_rng), height);
+        m_ambientCarry -= 1.0f;
+    }
+}
+
+void ParticleSystem::Update(float dt) {
+    const float drag = std::max(0.0f, 1.0f - 1.5f * dt);
+    size_t i = 0;
+    while (i < m_count) {
+        float age = m_age[i] + dt;
+        if (age >= m_life[i]) {
+            // swap the last live particle into this slot and look at it next
+            size_t last = --m_count;
+            m_x[i] = m_x[last]; m_y[i] = m_y[last];
+            m_vx[i] = m_vx[last]; m_vy[i] = m_vy[last];
+            m_age[i] = m_age[last]; m_life[i] = m_life[last];
+            m_size[i] = m_size[last]; m_rise[i] = m_rise[last];
+            m_r[i] = m_r[last]; m_g[i] = m_g[last]; m_b[i] = m_b[last];
+            continue;
+        }
+        m_age[i] = age;
+        m_vx[i] *= drag;
+        m_vy[i] = m_vy[i] * drag + m_rise[i] * dt;
+        m_x[i] += m_vx[i] * dt;
+        m_y[i] += m_vy[i] * dt;
+        ++i;
+    }
+}
+
+void ParticleSystem::PrepareVertices() {
+    for (size_t i = 0; i < m_count; ++i) {
+        m_positions[2 * i] = m_x[i];
+        m_positions[2 * i + 1] = m_y[i];
+        m_colors[i].set(m_r[i], m_g[i], m_b[i], 1.0f - m_age[i] / m_life[i]);
+        m_sizes[i] = m_size[i];
+    }
+}
+
+void ParticleSystem::setupGL() {
+    m_shader.setupShaderFromSource(GL_VERTEX_SHADER, VertexShader);
+    m_shader.setupShaderFromSource(GL_FRAGMENT_SHADER, FragmentShader);
+    m_shader.bindDefaults();
+    m_shader.linkProgram();
+    m_sizeAttribute = m_shader.getAttributeLocation("pointSize");
+
+    // sized for the whole capacity once, every frame only updates the live part
+    m_vbo.setVertexData(m_positions.data(), 2, int(m_capacity), GL_DYNAMIC_DRAW);
+    m_vbo.setColorData(m_colors.data(), int(m_capacity), GL_DYNAMIC_DRAW);
+    m_vbo.setAttributeData(m_sizeAttribute, m_sizes.data(), 1, int(m_capacity), GL_DYNAMIC_DRAW);
+    m_glReady = true;
+}
+
+void ParticleSystem::Draw() {
+    if (m_count == 0) { return; }
+    if (!m_glReady) { this->setupGL(); }
+
+    this->PrepareVertices();
+    m_vbo.updateVertexData(m_positions.data(), int(m_count));
+    m_vbo.updateColorData(m_colors.data(), int(m_count));
+    m_vbo.updateAttributeData(m_sizeAttribute, m_sizes.data(), int(m_count));
+
+    ofPushStyle();
+    ofEnableBlendMode(OF_BLENDMODE_ADD);
+    ofEnablePointSprites();
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    m_shader.begin();
+    m_vbo.draw(GL_POINTS, 0, int(m_count));
+    m_shader.end();
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    ofDisablePointSprites();
+    ofPopStyle();
+}
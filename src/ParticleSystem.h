@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "ofMain.h"
+
+enum class ParticleEffect {
+    Bubble,   // ambient, rises from the floor
+    Eat,      // player ate something
+    Hurt,     // player lost a life
+    PowerUp,  // power up picked up
+    Trail,    // behind the player while boosted
+    Count
+};
+
+// Decorative particles (bubbles, eat bursts, power-up trails). They live
+// outside m_creatures so collisions and Aquarium::update never see them.
+// State is kept as plain float arrays and advanced by one tight loop; the
+// positions, colors and sizes are then streamed into a single VBO and drawn
+// as point sprites in one call. Storage is allocated on the first Emit and
+// never grows, so a headless scene that never emits costs nothing.
+class ParticleSystem {
+    public:
+        explicit ParticleSystem(size_t capacity = 65536) : m_capacity(capacity), m_budget(capacity) {}
+
+        // Spawns `count` particles of the effect at x, y (-1 uses the
+        // effect's default count). Particles past the budget are dropped.
+        void Emit(ParticleEffect effect, float x, float y, int count = -1);
+        // Keeps a steady stream of bubbles rising from the bottom of the tank.
+        void EmitAmbient(float dt, float width, float height);
+
+        void Update(float dt);
+        // Writes the live particles into the upload arrays. Draw() calls it,
+        // it is public so the benchmark can time it without a GL context.
+        void PrepareVertices();
+        void Draw();
+        void Clear() { m_count = 0; }
+        // Caps live particles below capacity, lowered when frames run long.
+        // Particles already alive past the budget just run out their life.
+        void SetBudget(size_t budget) { m_budget = std::min(budget, m_capacity); }
+        size_t GetBudget() const { return m_budget; }
+
+        size_t GetCount() const { return m_count; }
+        size_t GetCapacity() const { return m_capacity; }
+        size_t GetDroppedCount() const { return m_dropped; }
+
+        float bubblesPerSecond = 40.0f;
+
+    private:
+        void allocate();
+        void setupGL();
+
+        size_t m_capacity;
+        size_t m_budget;
+        size_t m_count = 0;
+        size_t m_dropped = 0;
+        float m_ambientCarry = 0.0f; // fractional bubbles left over from last frame
+
+        // one array per field, index i is particle i
+        std::vector<float> m_x, m_y, m_vx, m_vy;
+        std::vector<float> m_age, m_life, m_size, m_rise;
+        std::vector<float> m_r, m_g, m_b;
+
+        // what goes to the GPU
+        std::vector<float> m_positions; // x, y pairs
+        std::vector<ofFloatColor> m_colors;
+        std::vector<float> m_sizes;
+
+        ofVbo m_vbo;
+        ofShader m_shader;
+        int m_sizeAttribute = -1;
+        bool m_glReady = false;
+
+        std::minstd_rand m_rng{1234}; // not the game rng, effects must not change gameplay
+};
@@ -0,0 +1,10 @@
+#include "PlayerController.h"
+#include "Aquarium.h"
+#include "InputState.h"
+
+void HumanController::Drive(PlayerCreature& player, const Aquarium& /*aquarium*/) {
+    // everything pressed since last tick, the latency is measured here
+    const InputSample& input = m_input.Consume(ofGetElapsedTimeMicros());
+    player.setDirection(input.moveX, input.moveY);
+    player.setSprinting(input.Has(InputAction::Boost));
+}
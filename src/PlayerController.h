@@ -0,0 +1,25 @@
+#pragma once
+
+class Aquarium;
+class PlayerCreature;
+class InputState;
+
+// Whatever steers the player: the keyboard/gamepad or a bot. The scene
+// calls Drive() once per tick before simulating it, windowed or headless.
+class PlayerController {
+    public:
+        virtual ~PlayerController() = default;
+        virtual const char* GetName() const = 0;
+        virtual void Drive(PlayerCreature& player, const Aquarium& aquarium) = 0;
+};
+
+// The human at the keyboard, through the flat input state.
+class HumanController : public PlayerController {
+    public:
+        explicit HumanController(InputState& input) : m_input(input) {}
+        const char* GetName() const override { return "human"; }
+        void Drive(PlayerCreature& player, const Aquarium& aquarium) override;
+
+    private:
+        InputState& m_input;
+};
@@ -0,0 +1,199 @@
+#include "PredatorChain.h"
+#include <cmath>
+#include <algorithm>
+
+PredatorChainPool::ChainId PredatorChainPool::Allocate(int segmentCount, float headX, float headY, float spacing) {
+    if (segmentCount <= 0) { return InvalidChain; }
+
+    ChainId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = static_cast<ChainId>(m_chains.size());
+        m_chains.emplace_back();
+    }
+
+    Chain& chain = m_chains[id];
+    chain.offset = this->takeRange(segmentCount);
+    chain.count = segmentCount;
+    chain.spacing = spacing;
+    chain.alive = true;
+
+    // segments start laid out in a straight line behind the head
+    for (int i = 0; i < segmentCount; ++i) {
+        m_xs[chain.offset + i] = headX - i * spacing;
+        m_ys[chain.offset + i] = headY;
+    }
+    this->fitBounds(chain);
+    ++m_liveChains;
+    m_liveSegments += size_t(segmentCount);
+    m_lanesDirty = true;
+    return id;
+}
+
+void PredatorChainPool::Release(ChainId id) {
+    if (id < 0 || size_t(id) >= m_chains.size() || !m_chains[id].alive) { return; }
+
+    // the segments stay where they are as a hole for the next Allocate,
+    // Solve only walks live lanes so it never sees them
+    Chain& dead = m_chains[id];
+    this->freeRange(dead.offset, dead.count);
+    m_liveSegments -= size_t(dead.count);
+    dead = Chain();
+    m_freeIds.push_back(id);
+    --m_liveChains;
+    m_lanesDirty = true;
+
+    if (m_xs.size() - m_liveSegments > m_liveSegments) {
+        this->compact();
+    }
+}
+
+size_t PredatorChainPool::takeRange(int count) {
+    // first hole that fits, predators come in a couple of lengths so the
+    // holes get reused whole most of the time
+    for (size_t r = 0; r < m_freeRanges.size(); ++r) {
+        Range& range = m_freeRanges[r];
+        if (range.count < count) { continue; }
+        size_t offset = range.offset;
+        range.offset += size_t(count);
+        range.count -= count;
+        if (range.count == 0) { m_freeRanges.erase(m_freeRanges.begin() + r); }
+        return offset;
+    }
+    size_t offset = m_xs.size();
+    m_xs.resize(offset + size_t(count));
+    m_ys.resize(offset + size_t(count));
+    return offset;
+}
+
+void PredatorChainPool::freeRange(size_t offset, int count) {
+    auto next = std::lower_bound(m_freeRanges.begin(), m_freeRanges.end(), offset,
+                                 [](const Range& range, size_t at) { return range.offset < at; });
+    next = m_freeRanges.insert(next, Range{ offset, count });
+    // merge with the hole after and the one before
+    if (next + 1 != m_freeRanges.end() && next->offset + size_t(next->count) == (next + 1)->offset) {
+        next->count += (next + 1)->count;
+        m_freeRanges.erase(next + 1);
+    }
+    if (next != m_freeRanges.begin() && (next - 1)->offset + size_t((next - 1)->count) == next->offset) {
+        (next - 1)->count += next->count;
+        next = m_freeRanges.erase(next) - 1;
+    }
+    // a hole at the very end just shortens the arrays
+    if (next->offset + size_t(next->count) == m_xs.size()) {
+        m_xs.resize(next->offset);
+        m_ys.resize(next->offset);
+        m_freeRanges.erase(next);
+    }
+}
+
+void PredatorChainPool::compact() {
+    // live chains keep their order in memory, each slides down over the holes
+    std::vector<ChainId> order;
+    order.reserve(size_t(m_liveChains));
+    for (ChainId id = 0; id < ChainId(m_chains.size()); ++id) {
+        if (m_chains[id].alive) { order.push_back(id); }
+    }
+    std::sort(order.begin(), order.end(), [this](ChainId a, ChainId b) { return m_chains[a].offset < m_chains[b].offset; });
+    size_t write = 0;
+    for (ChainId id : order) {
+        Chain& chain = m_chains[id];
+        if (chain.offset != write) {
+            std::copy(m_xs.begin() + chain.offset, m_xs.begin() + chain.offset + chain.count, m_xs.begin() + write);
+            std::copy(m_ys.begin() + chain.offset, m_ys.begin() + chain.offset + chain.count, m_ys.begin() + write);
+            chain.offset = write;
+        }
+        write += size_t(chain.count);
+    }
+    m_xs.resize(write);
+    m_ys.resize(write);
+    m_freeRanges.clear();
+    m_lanesDirty = true;
+}
+
+void PredatorChainPool::SetHead(ChainId id, float x, float y) {
+    if (id < 0 || size_t(id) >= m_chains.size() || !m_chains[id].alive) { return; }
+    Chain& chain = m_chains[id];
+    m_xs[chain.offset] = x;
+    m_ys[chain.offset] = y;
+    // the body hasn't followed yet, so the old box plus the new head still
+    // covers everything until Solve refits it
+    chain.bounds.include(x, y);
+}
+
+void PredatorChainPool::Write(ChainId id, const float* xs, const float* ys, int count) {
+    if (id < 0 || size_t(id) >= m_chains.size() || !m_chains[id].alive) { return; }
+    Chain& chain = m_chains[id];
+    std::copy(xs, xs + std::min(count, chain.count), m_xs.begin() + chain.offset);
+    std::copy(ys, ys + std::min(count, chain.count), m_ys.begin() + chain.offset);
+    this->fitBounds(chain);
+}
+
+ChainView PredatorChainPool::GetChain(ChainId id) const {
+    if (id < 0 || size_t(id) >= m_chains.size() || !m_chains[id].alive) { return ChainView(); }
+    const Chain& chain = m_chains[id];
+    return ChainView{ m_xs.data() + chain.offset, m_ys.data() + chain.offset, size_t(chain.count) };
+}
+
+ChainBounds PredatorChainPool::GetBounds(ChainId id) const {
+    if (id < 0 || size_t(id) >= m_chains.size() || !m_chains[id].alive) { return ChainBounds(); }
+    return m_chains[id].bounds;
+}
+
+void PredatorChainPool::fitBounds(Chain& chain) const {
+    const float* xs = m_xs.data() + chain.offset;
+    const float* ys = m_ys.data() + chain.offset;
+    ChainBounds bounds{ xs[0], ys[0], xs[0], ys[0] };
+    for (int i = 1; i < chain.count; ++i) {
+        bounds.include(xs[i], ys[i]);
+    }
+    chain.bounds = bounds;
+}
+
+void PredatorChainPool::buildLanes() {
+    m_lanes.clear();
+    for (const Chain& chain : m_chains) {
+        if (!chain.alive) { continue; }
+        m_lanes.push_back(Lane{ chain.offset, chain.count, chain.spacing });
+    }
+    // longest chains first so each sweep only touches a prefix of the lanes
+    std::sort(m_lanes.begin(), m_lanes.end(), [](const Lane& a, const Lane& b) { return a.count > b.count; });
+    m_lanesDirty = false;
+}
+
+void PredatorChainPool::Solve() {
+    // Every segment depends on the one in front of it, so a single chain is
+    // a serial dependency (sqrt then divide then the next segment). Instead
+    // we sweep segment index i across all chains at once: the inner loop
+    // runs over independent chains, so the CPU can overlap their work and
+    // the compiler is free to vectorize it.
+    if (m_lanesDirty) { this->buildLanes(); }
+    const int longest = m_lanes.empty() ? 0 : m_lanes.front().count;
+
+    float* __restrict xs = m_xs.data();
+    float* __restrict ys = m_ys.data();
+    size_t active = m_lanes.size();
+    for (int i = 1; i < longest; ++i) {
+        while (active > 0 && m_lanes[active - 1].count <= i) { --active; }
+        for (size_t l = 0; l < active; ++l) {
+            const size_t cur = m_lanes[l].offset + i;
+            float dx = xs[cur - 1] - xs[cur];
+            float dy = ys[cur - 1] - ys[cur];
+            float distSq = dx * dx + dy * dy;
+            if (distSq > 0.0001f * 0.0001f) {
+                float dist = std::sqrt(distSq);
+                float k = (dist - m_lanes[l].spacing) / dist;
+                xs[cur] += dx * k;
+                ys[cur] += dy * k;
+            }
+        }
+    }
+
+    // a separate pass over each chain's own (contiguous) segments, folding
+    // it into the sweep above would make every lane write back every step
+    for (Chain& chain : m_chains) {
+        if (chain.alive) { this->fitBounds(chain); }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+// Read-only view over one predator chain inside the pool. It does not own or
+// copy anything, so it is only valid until the pool allocates or releases.
+struct ChainView {
+    const float* xs = nullptr;
+    const float* ys = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    float x(size_t i) const { return xs[i]; }
+    float y(size_t i) const { return ys[i]; }
+};
+
+// Box around every segment of a chain, segment centers only. Collision
+// checks pad it with their own radius.
+struct ChainBounds {
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+
+    void include(float x, float y) {
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+    }
+    // True when (x, y) is within `margin` of the box on both axes.
+    bool near(float x, float y, float margin) const {
+        return x >= minX - margin && x <= maxX + margin && y >= minY - margin && y <= maxY + margin;
+    }
+};
+
+// Shared storage for every predator body in an aquarium. Segment positions
+// live in two contiguous arrays (x and y) instead of one vector per predator,
+// so the follow-the-leader constraint can be solved for all chains in a
+// single pass over flat memory.
+class PredatorChainPool {
+    public:
+        using ChainId = int;
+        static constexpr ChainId InvalidChain = -1;
+
+        ChainId Allocate(int segmentCount, float headX, float headY, float spacing);
+        void Release(ChainId id);
+
+        void SetHead(ChainId id, float x, float y);
+        // Overwrites up to `count` segments of a chain with the given positions.
+        void Write(ChainId id, const float* xs, const float* ys, int count);
+        ChainView GetChain(ChainId id) const;
+        // Always holds the whole chain: SetHead grows it and Solve/Write
+        // shrink it back to fit.
+        ChainBounds GetBounds(ChainId id) const;
+
+        // Pulls every segment of every chain towards its leader so the gap
+        // becomes the chain spacing. Heads are left untouched. Refits every
+        // chain's bounds afterwards.
+        void Solve();
+
+        int GetChainCount() const { return m_liveChains; }
+        // Live segments; the arrays may hold a few released ones besides.
+        size_t GetSegmentCount() const { return m_liveSegments; }
+        // Everything the pool holds on to, capacity included.
+        size_t GetBytes() const {
+            return (m_xs.capacity() + m_ys.capacity()) * sizeof(float) + m_chains.capacity() * sizeof(Chain) +
+                   m_freeIds.capacity() * sizeof(ChainId) + m_lanes.capacity() * sizeof(Lane) +
+                   m_freeRanges.capacity() * sizeof(Range);
+        }
+
+    private:
+        struct Chain {
+            size_t offset = 0;
+            int count = 0;
+            float spacing = 0.0f;
+            bool alive = false;
+            ChainBounds bounds;
+        };
+
+        // live chains in the order Solve() sweeps them, longest first.
+        // Only rebuilt (and sorted) after chains come, go or move.
+        struct Lane {
+            size_t offset;
+            int count;
+            float spacing;
+        };
+
+        // released segments, sorted by offset and merged with neighbours
+        struct Range {
+            size_t offset;
+            int count;
+        };
+
+        std::vector<float> m_xs;
+        std::vector<float> m_ys;
+        std::vector<Chain> m_chains;
+        std::vector<ChainId> m_freeIds;
+        std::vector<Lane> m_lanes;
+        std::vector<Range> m_freeRanges;
+        bool m_lanesDirty = false;
+        int m_liveChains = 0;
+        size_t m_liveSegments = 0;
+
+        size_t takeRange(int count);
+        void freeRange(size_t offset, int count);
+        // Slides the live chains together once the holes outgrow them.
+        void compact();
+        void buildLanes();
+        void fitBounds(Chain& chain) const;
+};
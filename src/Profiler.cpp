@@ -0,0 +1,238 @@
+#include "Profiler.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include "ofMain.h"
+#include "Trace.h"
+
+namespace {
+
+const int MaxDepth = 32;
+
+// Written from any thread, so everything here is atomic. Plain arrays of
+// atomics are constant initialized, which matters because operator new can
+// run before main.
+struct Slot {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> micros;
+    std::atomic<uint64_t> allocs;
+    std::atomic<uint64_t> bytes;
+};
+Slot g_slots[Profiler::MaxScopes];
+const char* g_names[Profiler::MaxScopes] = {"(other)"};
+std::atomic<int> g_scopeCount{1};
+std::mutex g_registerMutex;
+std::atomic<bool> g_enabled{true};
+std::atomic<uint64_t> g_frees{0};
+
+thread_local int t_stack[MaxDepth];
+thread_local int t_depth = 0;
+
+// Main thread only, filled by NextFrame().
+struct Totals {
+    uint64_t calls = 0;
+    uint64_t micros = 0;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    uint64_t worstFrameAllocs = 0;
+    uint64_t violations = 0;
+    int64_t budget = -1;
+    bool warned = false;
+};
+Profiler::ScopeStats g_lastFrame[Profiler::MaxScopes];
+Totals g_totals[Profiler::MaxScopes];
+Profiler::FrameStats g_lastTotals;
+Profiler::FrameStats g_history[Profiler::HistoryFrames];
+uint64_t g_frameCount = 0;
+std::chrono::steady_clock::time_point g_frameStart;
+
+}
+
+int Profiler::RegisterScope(const char* name) {
+    std::lock_guard<std::mutex> lock(g_registerMutex);
+    int count = g_scopeCount.load();
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(g_names[i], name) == 0) { return i; }
+    }
+    if (count == MaxScopes) { return 0; } // out of slots, lump it in with (other)
+    g_names[count] = name;
+    g_scopeCount.store(count + 1);
+    return count;
+}
+
+void Profiler::Enter(int slot) {
+    if (t_depth < MaxDepth) { t_stack[t_depth] = slot; }
+    ++t_depth;
+    g_slots[slot].calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::Leave(int slot, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    --t_depth;
+    uint64_t micros = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    g_slots[slot].micros.fetch_add(micros, std::memory_order_relaxed);
+    if (Trace::IsRecording()) {
+        Trace::Complete(g_names[slot], start, end);
+    }
+}
+
+const char* Profiler::GetScopeName(int slot) {
+    return g_names[slot];
+}
+
+void Profiler::SetEnabled(bool enabled) { g_enabled.store(enabled); }
+bool Profiler::IsEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+void Profiler::RecordAllocation(size_t bytes) {
+    int slot = t_depth > 0 ? t_stack[std::min(t_depth, MaxDepth) - 1] : 0;
+    g_slots[slot].allocs.fetch_add(1, std::memory_order_relaxed);
+    g_slots[slot].bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void Profiler::RecordFree() {
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::NextFrame() {
+    auto now = std::chrono::steady_clock::now();
+    FrameStats frame;
+    frame.frame = g_frameCount;
+    if (g_frameCount > 0) {
+        frame.micros = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - g_frameStart).count());
+    }
+    g_frameStart = now;
+
+    int count = g_scopeCount.load();
+    for (int i = 0; i < count; ++i) {
+        ScopeStats& stats = g_lastFrame[i];
+        stats.name = g_names[i];
+        stats.calls = g_slots[i].calls.exchange(0, std::memory_order_relaxed);
+        stats.micros = g_slots[i].micros.exchange(0, std::memory_order_relaxed);
+        stats.allocs = g_slots[i].allocs.exchange(0, std::memory_order_relaxed);
+        stats.bytes = g_slots[i].bytes.exchange(0, std::memory_order_relaxed);
+        frame.allocs += stats.allocs;
+        frame.bytes += stats.bytes;
+
+        Totals& totals = g_totals[i];
+        totals.calls += stats.calls;
+        totals.micros += stats.micros;
+        totals.allocs += stats.allocs;
+        totals.bytes += stats.bytes;
+        totals.worstFrameAllocs = std::max(totals.worstFrameAllocs, stats.allocs);
+        if (totals.budget >= 0 && int64_t(stats.allocs) > totals.budget) {
+            ++totals.violations;
+            if (!totals.warned) {
+                ofLogWarning() << "Profiler: '" << g_names[i] << "' allocated " << stats.allocs
+                               << " times in frame " << g_frameCount << ", budget is " << totals.budget;
+                totals.warned = true;
+            }
+        }
+    }
+    frame.frees = g_frees.exchange(0, std::memory_order_relaxed);
+
+    g_lastTotals = frame;
+    g_history[g_frameCount % HistoryFrames] = frame;
+    ++g_frameCount;
+}
+
+const Profiler::ScopeStats& Profiler::GetLastFrame(int slot) { return g_lastFrame[slot]; }
+const Profiler::FrameStats& Profiler::GetLastFrameTotals() { return g_lastTotals; }
+int Profiler::GetScopeCount() { return g_scopeCount.load(); }
+
+void Profiler::SetAllocationBudget(const char* name, int64_t maxAllocs) {
+    g_totals[RegisterScope(name)].budget = maxAllocs;
+}
+
+float Profiler::DrawOverlay(float x, float y) {
+    char line[128];
+    const FrameStats& frame = g_lastTotals;
+    std::snprintf(line, sizeof(line), "frame %llu  %.2f ms", (unsigned long long)frame.frame, frame.micros / 1000.0);
+    ofDrawBitmapStringHighlight(line, x, y);
+    y += 16;
+    if (TracksAllocations) {
+        std::snprintf(line, sizeof(line), "heap: %llu allocs  %llu bytes  %llu frees",
+                      (unsigned long long)frame.allocs, (unsigned long long)frame.bytes, (unsigned long long)frame.frees);
+    } else {
+        std::snprintf(line, sizeof(line), "heap: build with AQUARIUM_TRACK_ALLOCATIONS");
+    }
+    ofDrawBitmapStringHighlight(line, x, y);
+    y += 16;
+
+    int count = GetScopeCount();
+    for (int i = 0; i < count; ++i) {
+        const ScopeStats& stats = g_lastFrame[i];
+        if (stats.calls == 0 && stats.allocs == 0) { continue; }
+        std::snprintf(line, sizeof(line), "%-14s %6.2f ms %5llu allocs %8llu B", stats.name, stats.micros / 1000.0,
+                      (unsigned long long)stats.allocs, (unsigned long long)stats.bytes);
+        ofDrawBitmapStringHighlight(line, x, y);
+        y += 16;
+    }
+    return y;
+}
+
+bool Profiler::WriteReport(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) { return false; }
+
+    out << "frames: " << g_frameCount << "\n";
+    out << "allocation tracking: " << (TracksAllocations ? "on" : "off (build with AQUARIUM_TRACK_ALLOCATIONS)") << "\n\n";
+    out << "scope                calls   total ms     allocs        bytes  worst frame  budget  violations\n";
+    int count = GetScopeCount();
+    for (int i = 0; i < count; ++i) {
+        const Totals& totals = g_totals[i];
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-18s %8llu %10.2f %10llu %12llu %12llu %7lld %11llu\n", g_names[i],
+                      (unsigned long long)totals.calls, totals.micros / 1000.0, (unsigned long long)totals.allocs,
+                      (unsigned long long)totals.bytes, (unsigned long long)totals.worstFrameAllocs,
+                      (long long)totals.budget, (unsigned long long)totals.violations);
+        out << line;
+    }
+
+    out << "\nframe,ms,allocs,bytes,frees\n";
+    uint64_t first = g_frameCount > HistoryFrames ? g_frameCount - HistoryFrames : 0;
+    for (uint64_t f = first; f < g_frameCount; ++f) {
+        const FrameStats& frame = g_history[f % HistoryFrames];
+        out << frame.frame << "," << frame.micros / 1000.0 << "," << frame.allocs << "," << frame.bytes << "," << frame.frees << "\n";
+    }
+    return bool(out);
+}
+
+#ifdef AQUARIUM_TRACK_ALLOCATIONS
+
+// Global allocation hooks. Only sizes and counts are recorded, the memory
+// itself comes straight from malloc.
+void* operator new(std::size_t size) {
+    Profiler::RecordAllocation(size);
+    if (void* p = std::malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    Profiler::RecordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) { return; }
+    Profiler::RecordFree();
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+
+#endif
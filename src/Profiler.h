@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Frame profiler. Code marks phases with PROFILE_SCOPE("name"); every scope
+// gets a slot that collects calls and time (inclusive of nested scopes)
+// for the current frame, and ofApp closes the frame with NextFrame().
+//
+// Building with AQUARIUM_TRACK_ALLOCATIONS (add it to PROJECT_DEFINES in
+// config.make) also replaces the global new/delete and charges every
+// allocation to the innermost scope open on the calling thread. Threads
+// without an open scope are charged to "(other)". Without the define
+// nothing hooks the heap and the allocation columns stay at zero.
+//
+// While Trace is recording, every scope is also written to the trace.
+class Profiler {
+    public:
+        static constexpr int MaxScopes = 64;
+        static constexpr int HistoryFrames = 600;
+#ifdef AQUARIUM_TRACK_ALLOCATIONS
+        static constexpr bool TracksAllocations = true;
+#else
+        static constexpr bool TracksAllocations = false;
+#endif
+
+        struct ScopeStats {
+            const char* name = "";
+            uint64_t calls = 0;
+            uint64_t micros = 0;
+            uint64_t allocs = 0;
+            uint64_t bytes = 0;
+        };
+
+        struct FrameStats {
+            uint64_t frame = 0;
+            uint64_t micros = 0; // NextFrame to NextFrame
+            uint64_t allocs = 0;
+            uint64_t bytes = 0;
+            uint64_t frees = 0;
+        };
+
+        // Returns the slot for `name`, registering it the first time. The
+        // name must outlive the program (string literals).
+        static int RegisterScope(const char* name);
+        static void Enter(int slot);
+        static void Leave(int slot, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+        static const char* GetScopeName(int slot);
+
+        // Headless runs turn it off so worker threads don't share counters.
+        static void SetEnabled(bool enabled);
+        static bool IsEnabled();
+
+        // Ends the current frame: its counters become GetLastFrame() and the
+        // next frame starts from zero. Main thread only.
+        static void NextFrame();
+        static const ScopeStats& GetLastFrame(int slot);
+        static const FrameStats& GetLastFrameTotals();
+        static int GetScopeCount();
+
+        // More than `maxAllocs` allocations in the scope during one frame is
+        // logged (once per scope) and counted as a violation in the report.
+        static void SetAllocationBudget(const char* name, int64_t maxAllocs);
+
+        // Text overlay in the top left corner. Returns the y below the last
+        // line so callers can add their own.
+        static float DrawOverlay(float x, float y);
+        // Per-scope totals plus the last HistoryFrames frames.
+        static bool WriteReport(const std::string& path);
+
+        // Called by the global new/delete hooks.
+        static void RecordAllocation(size_t bytes);
+        static void RecordFree();
+};
+
+class ProfileScope {
+    public:
+        explicit ProfileScope(int slot) : m_slot(slot), m_active(Profiler::IsEnabled()) {
+            if (m_active) {
+                Profiler::Enter(m_slot);
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        ~ProfileScope() {
+            if (m_active) {
+                Profiler::Leave(m_slot, m_start, std::chrono::steady_clock::now());
+            }
+        }
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        int m_slot;
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CONCAT(profileSlot_, __LINE__) = Profiler::RegisterScope(name); \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileSlot_, __LINE__))
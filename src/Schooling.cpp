@@ -0,0 +1,162 @@
+#include "Schooling.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+
+// UniformGrid
+
+int UniformGrid::CellX(float x) const {
+    int c = static_cast<int>(x * m_invCellSize);
+    return std::min(std::max(c, 0), m_columns - 1);
+}
+
+int UniformGrid::CellY(float y) const {
+    int c = static_cast<int>(y * m_invCellSize);
+    return std::min(std::max(c, 0), m_rows - 1);
+}
+
+void UniformGrid::Build(const float* xs, const float* ys, size_t count, float width, float height, float cellSize) {
+    m_invCellSize = 1.0f / cellSize;
+    m_columns = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+
+    const size_t cells = size_t(m_columns) * m_rows;
+    m_cellStart.assign(cells + 1, 0);
+    m_cellOf.resize(count);
+    m_cellItems.resize(count);
+
+    // count, prefix sum, then scatter
+    for (size_t i = 0; i < count; ++i) {
+        int cell = CellY(ys[i]) * m_columns + CellX(xs[i]);
+        m_cellOf[i] = cell;
+        ++m_cellStart[cell + 1];
+    }
+    for (size_t c = 0; c < cells; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+    // cellStart[cell] is used as the write cursor while scattering, which
+    // leaves every entry pointing at the next cell; shift it back after
+    for (size_t i = 0; i < count; ++i) {
+        m_cellItems[m_cellStart[m_cellOf[i]]++] = static_cast<int>(i);
+    }
+    for (size_t c = cells; c > 0; --c) {
+        m_cellStart[c] = m_cellStart[c - 1];
+    }
+    m_cellStart[0] = 0;
+}
+
+// SchoolingSystem
+
+void SchoolingSystem::Clear() {
+    m_xs.clear(); m_ys.clear(); m_dxs.clear(); m_dys.clear();
+    m_threatXs.clear(); m_threatYs.clear();
+}
+
+void SchoolingSystem::AddFish(float x, float y, float dx, float dy) {
+    m_xs.push_back(x);
+    m_ys.push_back(y);
+    m_dxs.push_back(dx);
+    m_dys.push_back(dy);
+}
+
+void SchoolingSystem::AddThreat(float x, float y) {
+    m_threatXs.push_back(x);
+    m_threatYs.push_back(y);
+}
+
+void SchoolingSystem::Solve(float width, float height, WorkerPool* pool) {
+    const size_t count = m_xs.size();
+    m_outDx.resize(count);
+    m_outDy.resize(count);
+    if (count == 0) { return; }
+
+    m_grid.Build(m_xs.data(), m_ys.data(), count, width, height, m_params.neighborRadius);
+
+    if (pool) {
+        pool->ParallelFor(count, 256, [this](size_t begin, size_t end) { solveRange(begin, end); });
+    } else {
+        solveRange(0, count);
+    }
+}
+
+void SchoolingSystem::solveRange(size_t begin, size_t end) {
+    const SchoolingParams& p = m_params;
+    const float neighborSq = p.neighborRadius * p.neighborRadius;
+    const float separationSq = p.separationRadius * p.separationRadius;
+    const float fleeSq = p.fleeRadius * p.fleeRadius;
+    const std::vector<int>& cellStart = m_grid.GetCellStart();
+    const std::vector<int>& cellItems = m_grid.GetCellItems();
+    const int columns = m_grid.GetColumns();
+
+    for (size_t i = begin; i < end; ++i) {
+        const float x = m_xs[i];
+        const float y = m_ys[i];
+        float sepX = 0, sepY = 0, alignX = 0, alignY = 0, centerX = 0, centerY = 0;
+        int neighbors = 0;
+
+        // the cell size equals the neighbor radius, so the 3x3 block around
+        // the fish covers every candidate
+        const int cx = m_grid.CellX(x);
+        const int cy = m_grid.CellY(y);
+        const int x0 = std::max(cx - 1, 0), x1 = std::min(cx + 1, columns - 1);
+        const int y0 = std::max(cy - 1, 0), y1 = std::min(cy + 1, m_grid.GetRows() - 1);
+        for (int gy = y0; gy <= y1 && neighbors < p.maxNeighbors; ++gy) {
+            for (int gx = x0; gx <= x1 && neighbors < p.maxNeighbors; ++gx) {
+                const int cell = gy * columns + gx;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    const int j = cellItems[k];
+                    if (size_t(j) == i) { continue; }
+                    const float ox = x - m_xs[j];
+                    const float oy = y - m_ys[j];
+                    const float distSq = ox * ox + oy * oy;
+                    if (distSq >= neighborSq) { continue; }
+
+                    if (distSq < separationSq && distSq > 0.0001f) {
+                        sepX += ox / distSq;
+                        sepY += oy / distSq;
+                    }
+                    alignX += m_dxs[j];
+                    alignY += m_dys[j];
+                    centerX += m_xs[j];
+                    centerY += m_ys[j];
+                    if (++neighbors >= p.maxNeighbors) { break; }
+                }
+            }
+        }
+
+        float hx = m_dxs[i] * p.inertiaWeight;
+        float hy = m_dys[i] * p.inertiaWeight;
+        if (neighbors > 0) {
+            const float inv = 1.0f / neighbors;
+            // separation is scaled back to roughly unit length
+            hx += sepX * p.separationRadius * p.separationWeight;
+            hy += sepY * p.separationRadius * p.separationWeight;
+            hx += alignX * inv * p.alignmentWeight;
+            hy += alignY * inv * p.alignmentWeight;
+            hx += (centerX * inv - x) / p.neighborRadius * p.cohesionWeight;
+            hy += (centerY * inv - y) / p.neighborRadius * p.cohesionWeight;
+        }
+
+        for (size_t t = 0; t < m_threatXs.size(); ++t) {
+            const float ox = x - m_threatXs[t];
+            const float oy = y - m_threatYs[t];
+            const float distSq = ox * ox + oy * oy;
+            if (distSq < fleeSq && distSq > 0.0001f) {
+                // stronger the closer the threat is
+                const float dist = std::sqrt(distSq);
+                const float urgency = 1.0f - dist / p.fleeRadius;
+                hx += ox / dist * urgency * p.fleeWeight;
+                hy += oy / dist * urgency * p.fleeWeight;
+            }
+        }
+
+        const float len = std::sqrt(hx * hx + hy * hy);
+        if (len > 0.0001f) {
+            m_outDx[i] = hx / len;
+            m_outDy[i] = hy / len;
+        } else {
+            m_outDx[i] = m_dxs[i];
+            m_outDy[i] = m_dys[i];
+        }
+    }
+}
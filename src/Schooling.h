@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class WorkerPool;
+
+// Tuning for the schooling behavior of base fish. Radii are in pixels.
+struct SchoolingParams {
+    float neighborRadius = 80.0f;   // also used as the grid cell size
+    float separationRadius = 28.0f;
+    float fleeRadius = 180.0f;
+    int maxNeighbors = 12;          // hard cap on neighbors looked at per fish
+
+    float inertiaWeight = 1.0f;     // how much the current heading is kept
+    float separationWeight = 1.6f;
+    float alignmentWeight = 0.8f;
+    float cohesionWeight = 0.5f;
+    float fleeWeight = 3.0f;
+};
+
+// Uniform grid over the tank for fixed radius neighbor queries. Built with a
+// counting sort every tick, so the whole structure is three flat arrays and
+// rebuilding it never allocates once it has grown to the population size.
+class UniformGrid {
+    public:
+        void Build(const float* xs, const float* ys, size_t count, float width, float height, float cellSize);
+
+        int GetColumns() const { return m_columns; }
+        int GetRows() const { return m_rows; }
+        int CellX(float x) const;
+        int CellY(float y) const;
+
+        // Items of one cell are cellItems[cellStart[c] .. cellStart[c + 1]).
+        const std::vector<int>& GetCellStart() const { return m_cellStart; }
+        const std::vector<int>& GetCellItems() const { return m_cellItems; }
+        size_t GetBytes() const {
+            return (m_cellOf.capacity() + m_cellStart.capacity() + m_cellItems.capacity()) * sizeof(int);
+        }
+
+    private:
+        float m_invCellSize = 1.0f;
+        int m_columns = 0;
+        int m_rows = 0;
+        std::vector<int> m_cellOf;
+        std::vector<int> m_cellStart;
+        std::vector<int> m_cellItems;
+};
+
+// Boids (separation, alignment, cohesion) plus fleeing from threats, for
+// every schooling fish at once. Callers fill the fish and threats each tick,
+// call Solve(), and read back the new headings.
+class SchoolingSystem {
+    public:
+        SchoolingParams& GetParams() { return m_params; }
+        const SchoolingParams& GetParams() const { return m_params; }
+
+        void Clear();
+        void AddFish(float x, float y, float dx, float dy);
+        void AddThreat(float x, float y);
+
+        // Computes a normalized heading for every fish. Work is split across
+        // the worker pool when one is given.
+        void Solve(float width, float height, WorkerPool* pool);
+
+        size_t GetFishCount() const { return m_xs.size(); }
+        float GetHeadingX(size_t i) const { return m_outDx[i]; }
+        float GetHeadingY(size_t i) const { return m_outDy[i]; }
+        // Scratch arrays and grid, they keep their size between ticks.
+        size_t GetBytes() const {
+            return m_grid.GetBytes() + (m_xs.capacity() + m_ys.capacity() + m_dxs.capacity() + m_dys.capacity() +
+                                        m_outDx.capacity() + m_outDy.capacity() + m_threatXs.capacity() +
+                                        m_threatYs.capacity()) * sizeof(float);
+        }
+
+    private:
+        void solveRange(size_t begin, size_t end);
+
+        SchoolingParams m_params;
+        UniformGrid m_grid;
+
+        std::vector<float> m_xs, m_ys, m_dxs, m_dys;
+        std::vector<float> m_outDx, m_outDy;
+        std::vector<float> m_threatXs, m_threatYs;
+};
@@ -0,0 +1,155 @@
+#include "SoakRunner.h"
+#include "Aquarium.h"
+#include "Bots.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+bool SoakMonitor::Open(const std::string& csvPath) {
+    m_csv.open(csvPath);
+    if (!m_csv) { return false; }
+    m_csv << "seconds,frames,avg_ms,p99_ms,max_ms,rss_mb,games,best_score,best_level\n";
+    m_firstRss = GetResidentBytes();
+    return true;
+}
+
+void SoakMonitor::Frame(double frameMs, double nowSeconds) {
+    if (m_intervalStart < 0.0) { m_intervalStart = nowSeconds; }
+    int bucket = int(frameMs / BucketMs);
+    ++m_histogram[bucket < 0 ? 0 : (bucket > Buckets ? Buckets : bucket)];
+    ++m_frames;
+    ++m_totalFrames;
+    m_totalMs += frameMs;
+    if (frameMs > m_maxMs) { m_maxMs = frameMs; }
+
+    if (nowSeconds - m_intervalStart >= m_intervalSeconds) {
+        this->writeRow(nowSeconds);
+        m_intervalStart = nowSeconds;
+    }
+}
+
+void SoakMonitor::GameFinished(int score, int level) {
+    ++m_games;
+    if (score > m_bestScore) { m_bestScore = score; }
+    if (level > m_bestLevel) { m_bestLevel = level; }
+}
+
+double SoakMonitor::percentile(double p) const {
+    uint64_t target = uint64_t(p * m_frames);
+    uint64_t seen = 0;
+    for (int b = 0; b <= Buckets; ++b) {
+        seen += m_histogram[b];
+        if (seen > target) { return (b + 1) * BucketMs; } // upper edge of the bucket
+    }
+    return Buckets * BucketMs;
+}
+
+void SoakMonitor::writeRow(double nowSeconds) {
+    if (m_frames == 0) { return; }
+    m_lastRss = GetResidentBytes();
+    if (m_lastRss > m_peakRss) { m_peakRss = m_lastRss; }
+    char row[200];
+    std::snprintf(row, sizeof(row), "%.1f,%llu,%.3f,%.3f,%.3f,%.1f,%d,%d,%d\n", nowSeconds, (unsigned long long)m_frames,
+                  m_totalMs / m_frames, this->percentile(0.99), m_maxMs, m_lastRss / (1024.0 * 1024.0), m_games,
+                  m_bestScore, m_bestLevel);
+    if (m_csv) { m_csv << row << std::flush; }
+    std::cout << "[soak] " << row << std::flush;
+
+    std::fill(std::begin(m_histogram), std::end(m_histogram), 0u);
+    m_frames = 0;
+    m_totalMs = 0.0;
+    m_maxMs = 0.0;
+}
+
+void SoakMonitor::Finish(double nowSeconds) {
+    this->writeRow(nowSeconds);
+    const double mb = 1024.0 * 1024.0;
+    std::cout << "[soak] " << m_totalFrames << " frames, " << m_games << " games in " << std::fixed << std::setprecision(1)
+              << nowSeconds / 60.0 << " min. rss " << m_firstRss / mb << " MB at start, " << m_lastRss / mb
+              << " MB at end, " << m_peakRss / mb << " MB peak" << std::endl;
+}
+
+size_t SoakMonitor::GetResidentBytes() {
+#if defined(__linux__)
+    long pages = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) { return 0; }
+    int read = std::fscanf(statm, "%ld %ld", &pages, &resident);
+    std::fclose(statm);
+    return read == 2 ? size_t(resident) * size_t(sysconf(_SC_PAGESIZE)) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) { return 0; }
+    return size_t(info.resident_size);
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) { return 0; }
+    return size_t(counters.WorkingSetSize);
+#else
+    return 0;
+#endif
+}
+
+int RunSoak(const SoakOptions& options) {
+    ofSetLogLevel(OF_LOG_WARNING); // every life lost and level change gets logged otherwise
+    Profiler::SetEnabled(false);   // nothing closes the frames headless
+
+    std::unique_ptr<PlayerController> bot = MakeBot(options.bot, options.seed);
+    if (!bot) {
+        std::cerr << "Unknown bot '" << options.bot << "', pick one of: " << BotNames() << std::endl;
+        return 1;
+    }
+
+    LevelTable levels;
+    std::string error;
+    if (!LevelTable::LoadFromXml(ofToDataPath("settings.xml", true), levels, error)) {
+        std::cerr << "Using built-in levels: " << error << std::endl;
+        levels = LevelTable::Defaults();
+    }
+
+    // one game reused for the whole run, Restart() is part of what gets soaked
+    auto aquarium = std::make_shared<Aquarium>(WorldWidth, WorldHeight, nullptr);
+    aquarium->seed(options.seed);
+    aquarium->setLevelTable(levels);
+    aquarium->getSpawnScheduler().SetBudget(0, 0);
+    auto player = std::make_shared<PlayerCreature>(WorldWidth / 2 - 50, WorldHeight / 2 - 50, levels.playerSpeed, 0);
+    aquarium->Repopulate();
+    AquariumGameScene scene(player, aquarium, "soak");
+    scene.SetController(bot.get());
+
+    SoakMonitor monitor;
+    std::string csvPath = ofToDataPath("soak-" + ofGetTimestampString() + ".csv", true);
+    if (!monitor.Open(csvPath)) {
+        std::cerr << "could not open " << csvPath << ", reporting to stdout only" << std::endl;
+    }
+    std::cout << "[soak] " << bot->GetName() << " bot for " << options.minutes << " min" << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const double endSeconds = options.minutes * 60.0;
+    double now = 0.0;
+    while (now < endSeconds) {
+        auto frameStart = Clock::now();
+        scene.Simulate();
+        auto frameEnd = Clock::now();
+        now = std::chrono::duration<double>(frameEnd - start).count();
+        monitor.Frame(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count(), now);
+
+        if (scene.IsGameOver()) {
+            monitor.GameFinished(player->getScore(), aquarium->getCurrentLevel());
+            scene.Restart();
+        }
+    }
+    monitor.Finish(now);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Long running load statistics. Fed one frame time per frame; every
+// interval it appends a CSV row (frames, avg/p99/max frame time, resident
+// memory, games played) and at the end prints how memory moved over the run.
+// Frame times go into a fixed histogram, so hours of frames cost nothing.
+class SoakMonitor {
+    public:
+        static constexpr int Buckets = 5000;      // 0.01 ms each, 0 - 50 ms
+        static constexpr double BucketMs = 0.01;
+
+        explicit SoakMonitor(double intervalSeconds = 10.0) : m_intervalSeconds(intervalSeconds) {}
+
+        bool Open(const std::string& csvPath);
+        void Frame(double frameMs, double nowSeconds);
+        void GameFinished(int score, int level);
+        // Writes the last partial interval and prints the summary.
+        void Finish(double nowSeconds);
+
+        // Resident set size of this process, 0 where we can't tell.
+        static size_t GetResidentBytes();
+
+    private:
+        void writeRow(double nowSeconds);
+        double percentile(double p) const;
+
+        double m_intervalSeconds;
+        double m_intervalStart = -1.0;
+        std::ofstream m_csv;
+
+        uint32_t m_histogram[Buckets + 1] = {}; // last bucket is everything slower
+        uint64_t m_frames = 0;
+        double m_totalMs = 0.0;
+        double m_maxMs = 0.0;
+
+        uint64_t m_totalFrames = 0;
+        int m_games = 0;
+        int m_bestScore = 0;
+        int m_bestLevel = 0;
+        size_t m_firstRss = 0;
+        size_t m_peakRss = 0;
+        size_t m_lastRss = 0;
+};
+
+struct SoakOptions {
+    std::string bot = "avoid";
+    double minutes = 60.0;   // wall clock
+    uint32_t seed = 1;
+};
+
+// Headless: the bot plays game after game as fast as the simulation goes,
+// single threaded, for `minutes`. Frame time is the cost of one tick. Run
+// with `./bin/Aquarium --soak [bot] [minutes]`, rows go to soak-<time>.csv.
+int RunSoak(const SoakOptions& options);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "CreatureTypes.h"
+
+// Queue of pending spawns drained a few at a time, so a level transition
+// spreads its 30+ spawns over several ticks instead of one long frame.
+// Storage is reused: once the queue has grown to a level's population it
+// never allocates again.
+class SpawnScheduler {
+    public:
+        // Either limit ends the tick's spawning; 0 disables that limit.
+        void SetBudget(int maxSpawnsPerTick, int maxMicrosPerTick) {
+            m_maxSpawns = maxSpawnsPerTick;
+            m_maxMicros = maxMicrosPerTick;
+        }
+        int GetMaxSpawnsPerTick() const { return m_maxSpawns; }
+        int GetMaxMicrosPerTick() const { return m_maxMicros; }
+
+        void Enqueue(AquariumCreatureType type) { m_queue.push_back(type); }
+        void Clear() { m_queue.clear(); m_head = 0; }
+        size_t Pending() const { return m_queue.size() - m_head; }
+        bool Empty() const { return Pending() == 0; }
+
+        template <typename Fn>
+        void ForEachPending(Fn&& fn) const {
+            for (size_t i = m_head; i < m_queue.size(); ++i) { fn(m_queue[i]); }
+        }
+
+        // Calls spawn(type) for queued entries until the queue is empty or the
+        // budget runs out. Returns how many were spawned.
+        template <typename SpawnFn>
+        int Drain(SpawnFn&& spawn) {
+            if (Empty()) { return 0; }
+            using Clock = std::chrono::steady_clock;
+            const Clock::time_point start = Clock::now();
+            int spawned = 0;
+            while (m_head < m_queue.size()) {
+                spawn(m_queue[m_head++]);
+                ++spawned;
+                if (m_maxSpawns > 0 && spawned >= m_maxSpawns) { break; }
+                if (m_maxMicros > 0 &&
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() >= m_maxMicros) {
+                    break;
+                }
+            }
+            if (m_head == m_queue.size()) {
+                Clear(); // keeps the capacity
+            }
+            return spawned;
+        }
+
+    private:
+        std::vector<AquariumCreatureType> m_queue;
+        size_t m_head = 0;
+        int m_maxSpawns = 8;
+        int m_maxMicros = 1000;
+};
@@ -0,0 +1,251 @@
+#include "SpriteAnimation.h"
+
+namespace {
+
+std::vector<SpriteSheet>& Sheets() {
+    static std::vector<SpriteSheet> sheets;
+    return sheets;
+}
+
+std::vector<AnimationDef>& Animations() {
+    static std::vector<AnimationDef> animations(1); // slot 0 is "not animated"
+    return animations;
+}
+
+int AttributeInt(const ofXml& node, const std::string& name, int fallback) {
+    auto attribute = node.getAttribute(name);
+    return attribute ? attribute.getIntValue() : fallback;
+}
+
+float AttributeFloat(const ofXml& node, const std::string& name, float fallback) {
+    auto attribute = node.getAttribute(name);
+    return attribute ? attribute.getFloatValue() : fallback;
+}
+
+// Picks the frame out of the sheet; everything per instance arrives as
+// vertex attributes, so one draw covers every animation on the sheet.
+const char* VertexShader = R"(
+#version 120
+attribute vec4 frameInfo; // age in seconds, first frame, frame count, fps
+uniform vec2 grid;        // columns, rows
+varying vec2 uv;
+void main() {
+    float frame = frameInfo.y + mod(floor(frameInfo.x * frameInfo.w), frameInfo.z);
+    vec2 cell = vec2(mod(frame, grid.x), floor(frame / grid.x));
+    uv = (cell + gl_MultiTexCoord0.xy) / grid;
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_FrontColor = gl_Color;
+}
+)";
+
+const char* FragmentShader = R"(
+#version 120
+uniform sampler2D sheet;
+varying vec2 uv;
+void main() {
+    gl_FragColor = texture2D(sheet, uv) * gl_Color;
+}
+)";
+
+// two triangles per instance
+constexpr int VerticesPerInstance = 6;
+constexpr float CornerX[VerticesPerInstance] = {0, 1, 1, 0, 1, 0};
+constexpr float CornerY[VerticesPerInstance] = {0, 0, 1, 0, 1, 1};
+
+}
+
+bool AnimationTable::LoadFromXml(const std::string& path, std::string& error) {
+    ofXml xml;
+    if (!xml.load(path)) {
+        error = "could not load " + path;
+        return false;
+    }
+    ofXml root = xml.getChild("animations");
+    if (!root) {
+        error = "no <animations> block in " + path;
+        return false;
+    }
+
+    std::vector<SpriteSheet> sheets;
+    std::vector<AnimationDef> animations(1);
+    for (const ofXml& sheetNode : root.getChildren("sheet")) {
+        SpriteSheet sheet;
+        sheet.image = sheetNode.getAttribute("image").getValue();
+        sheet.columns = std::max(1, AttributeInt(sheetNode, "columns", 1));
+        sheet.rows = std::max(1, AttributeInt(sheetNode, "rows", 1));
+        sheet.width = AttributeFloat(sheetNode, "width", 0.0f);
+        sheet.height = AttributeFloat(sheetNode, "height", sheet.width);
+        if (sheet.image.empty() || sheet.width <= 0.0f) {
+            error = "sheet " + std::to_string(sheets.size()) + " needs an image and a width";
+            return false;
+        }
+
+        const int frames = sheet.columns * sheet.rows;
+        for (const ofXml& animationNode : sheetNode.getChildren("animation")) {
+            AnimationDef animation;
+            animation.name = animationNode.getAttribute("name").getValue();
+            animation.sheet = uint16_t(sheets.size());
+            animation.firstFrame = uint16_t(std::max(0, AttributeInt(animationNode, "first", 0)));
+            animation.frameCount = uint16_t(std::max(1, AttributeInt(animationNode, "frames", 1)));
+            animation.fps = std::max(0.0f, AttributeFloat(animationNode, "fps", 0.0f));
+            if (animation.firstFrame + animation.frameCount > frames) {
+                error = "animation '" + animation.name + "' runs past the end of " + sheet.image;
+                return false;
+            }
+            animations.push_back(animation);
+        }
+        sheets.push_back(sheet);
+    }
+    if (animations.size() > 0xffff) {
+        error = "too many animations in " + path;
+        return false;
+    }
+
+    Sheets() = std::move(sheets);
+    Animations() = std::move(animations);
+    return true;
+}
+
+void AnimationTable::LoadTextures() {
+    // sheets are addressed in 0..1 texture coordinates
+    bool arb = ofGetUsingArbTex();
+    ofDisableArbTex();
+    for (SpriteSheet& sheet : Sheets()) {
+        if (!ofLoadImage(sheet.texture, sheet.image)) {
+            ofLogError() << "Failed to load sprite sheet: " << sheet.image;
+        }
+    }
+    if (arb) { ofEnableArbTex(); }
+}
+
+uint16_t AnimationTable::AddSheet(const SpriteSheet& sheet) {
+    Sheets().push_back(sheet);
+    return uint16_t(Sheets().size() - 1);
+}
+
+AnimationId AnimationTable::Add(const AnimationDef& animation) {
+    std::vector<AnimationDef>& animations = Animations();
+    if (animations.size() > 0xffff || animation.sheet >= Sheets().size()) {
+        ofLogError() << "Cannot add animation '" << animation.name << "'";
+        return 0;
+    }
+    animations.push_back(animation);
+    return AnimationId(animations.size() - 1);
+}
+
+AnimationId AnimationTable::Find(const std::string& name) {
+    const std::vector<AnimationDef>& animations = Animations();
+    for (size_t i = 1; i < animations.size(); ++i) {
+        if (animations[i].name == name) { return AnimationId(i); }
+    }
+    return 0;
+}
+
+const AnimationDef* AnimationTable::Get(AnimationId id) {
+    const std::vector<AnimationDef>& animations = Animations();
+    return id != 0 && id < animations.size() ? &animations[id] : nullptr;
+}
+
+const SpriteSheet* AnimationTable::GetSheet(uint16_t sheet) {
+    return sheet < Sheets().size() ? &Sheets()[sheet] : nullptr;
+}
+
+size_t AnimationTable::GetSheetCount() {
+    return Sheets().size();
+}
+
+size_t AnimationTable::GetCount() {
+    return Animations().size() - 1;
+}
+
+int AnimationTable::FrameAt(const AnimationDef& animation, uint32_t ageTicks) {
+    int step = int(ageTicks / TicksPerSecond * animation.fps);
+    return animation.firstFrame + step % animation.frameCount;
+}
+
+// AnimationBatch
+
+void AnimationBatch::Begin(uint64_t tick) {
+    m_tick = tick;
+    m_instances = 0;
+    m_pending = 0;
+    if (m_sheets.size() < AnimationTable::GetSheetCount()) {
+        m_sheets.resize(AnimationTable::GetSheetCount());
+    }
+    for (SheetBatch& batch : m_sheets) {
+        batch.count = 0;
+    }
+}
+
+void AnimationBatch::Add(AnimationId animation, uint16_t startTick, float x, float y, bool flipped) {
+    const AnimationDef* def = AnimationTable::Get(animation);
+    if (!def || def->sheet >= m_sheets.size()) { return; }
+    const SpriteSheet& sheet = *AnimationTable::GetSheet(def->sheet);
+    SheetBatch& batch = m_sheets[def->sheet];
+
+    // storage only ever grows, a steady frame reuses last frame's arrays
+    const size_t at = batch.count * VerticesPerInstance;
+    if (batch.positions.size() < (at + VerticesPerInstance) * 2) {
+        size_t vertices = std::max<size_t>(at * 2, 64 * VerticesPerInstance);
+        batch.positions.resize(vertices * 2);
+        batch.texCoords.resize(vertices * 2);
+        batch.frames.resize(vertices * 4);
+    }
+
+    // the age is the only thing that changes from frame to frame
+    const float age = uint16_t(uint16_t(m_tick) - startTick) / AnimationTable::TicksPerSecond;
+    for (int v = 0; v < VerticesPerInstance; ++v) {
+        const size_t i = at + size_t(v);
+        batch.positions[i * 2] = x + CornerX[v] * sheet.width;
+        batch.positions[i * 2 + 1] = y + CornerY[v] * sheet.height;
+        batch.texCoords[i * 2] = flipped ? 1.0f - CornerX[v] : CornerX[v];
+        batch.texCoords[i * 2 + 1] = CornerY[v];
+        batch.frames[i * 4] = age;
+        batch.frames[i * 4 + 1] = def->firstFrame;
+        batch.frames[i * 4 + 2] = def->frameCount;
+        batch.frames[i * 4 + 3] = def->fps;
+    }
+    ++batch.count;
+    ++m_instances;
+    ++m_pending;
+}
+
+void AnimationBatch::setupGL() {
+    m_shader.setupShaderFromSource(GL_VERTEX_SHADER, VertexShader);
+    m_shader.setupShaderFromSource(GL_FRAGMENT_SHADER, FragmentShader);
+    m_shader.bindDefaults();
+    m_shader.linkProgram();
+    m_frameAttribute = m_shader.getAttributeLocation("frameInfo");
+    m_glReady = true;
+}
+
+void AnimationBatch::Flush() {
+    if (m_pending == 0) { return; }
+    if (!m_glReady) { this->setupGL(); }
+
+    m_shader.begin();
+    for (size_t s = 0; s < m_sheets.size(); ++s) {
+        SheetBatch& batch = m_sheets[s];
+        if (batch.count == 0) { continue; }
+        const SpriteSheet& sheet = *AnimationTable::GetSheet(uint16_t(s));
+        const int vertices = int(batch.count) * VerticesPerInstance;
+        if (batch.count > batch.uploaded) {
+            // reallocate the buffers at the arrays' size, later frames update in place
+            const int capacity = int(batch.positions.size() / 2);
+            batch.vbo.setVertexData(batch.positions.data(), 2, capacity, GL_DYNAMIC_DRAW);
+            batch.vbo.setTexCoordData(batch.texCoords.data(), capacity, GL_DYNAMIC_DRAW);
+            batch.vbo.setAttributeData(m_frameAttribute, batch.frames.data(), 4, capacity, GL_DYNAMIC_DRAW);
+            batch.uploaded = size_t(capacity / VerticesPerInstance);
+        } else {
+            batch.vbo.updateVertexData(batch.positions.data(), vertices);
+            batch.vbo.updateTexCoordData(batch.texCoords.data(), vertices);
+            batch.vbo.updateAttributeData(m_frameAttribute, batch.frames.data(), vertices);
+        }
+        m_shader.setUniform2f("grid", float(sheet.columns), float(sheet.rows));
+        m_shader.setUniformTexture("sheet", sheet.texture, 0);
+        batch.vbo.draw(GL_TRIANGLES, 0, vertices);
+        batch.count = 0; // the arrays are reused for the next flush
+    }
+    m_shader.end();
+    m_pending = 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ofMain.h"
+
+// Creatures refer to animations by a 16-bit id into AnimationTable, like
+// sprites. Id 0 is "not animated", those creatures draw their sprite.
+using AnimationId = uint16_t;
+
+// A texture cut into columns x rows equal frames, numbered left to right
+// then top to bottom. Every frame is drawn at width x height world units.
+struct SpriteSheet {
+    std::string image;
+    int columns = 1;
+    int rows = 1;
+    float width = 0.0f;
+    float height = 0.0f;
+    ofTexture texture; // empty until LoadTextures, headless runs never load it
+};
+
+// A run of frames on one sheet, looped at fps. fps 0 holds the first frame,
+// which is how a plain single image is described.
+struct AnimationDef {
+    std::string name;
+    uint16_t sheet = 0;
+    uint16_t firstFrame = 0;
+    uint16_t frameCount = 1;
+    float fps = 0.0f;
+};
+
+// Every sheet and animation of the asset pack, read from animations.xml
+// once at startup. Ids stay valid until exit.
+class AnimationTable {
+    public:
+        // Replaces the table. On failure the table is left as it was and
+        // `error` says why.
+        static bool LoadFromXml(const std::string& path, std::string& error);
+        // Uploads the sheet images, needs a GL context.
+        static void LoadTextures();
+
+        static uint16_t AddSheet(const SpriteSheet& sheet);
+        static AnimationId Add(const AnimationDef& animation);
+        // 0 if there is no animation by that name.
+        static AnimationId Find(const std::string& name);
+        static const AnimationDef* Get(AnimationId id);
+        static const SpriteSheet* GetSheet(uint16_t sheet);
+        static size_t GetSheetCount();
+        static size_t GetCount();
+
+        // Frame shown `ageTicks` after the animation started. The shader does
+        // the same math per vertex, this is for code that needs to know.
+        static int FrameAt(const AnimationDef& animation, uint32_t ageTicks);
+        static constexpr float TicksPerSecond = 60.0f;
+};
+
+// Collects animated sprites for one frame and draws them with one call per
+// sheet. Each instance is two triangles whose vertices carry the animation's
+// first frame, frame count, fps and the instance's age; the vertex shader
+// picks the frame from those. So the CPU writes the same handful of floats
+// for an animated fish as for a static one.
+class AnimationBatch {
+    public:
+        // `tick` is the simulation tick being drawn, ages are counted from it.
+        void Begin(uint64_t tick);
+        // `startTick` is when the creature's animation started, as stored on
+        // the creature (16 bits, it wraps every 18 minutes and only the age
+        // matters). Drawn from its top left corner like GameSprite.
+        void Add(AnimationId animation, uint16_t startTick, float x, float y, bool flipped);
+        // Uploads and draws everything added since Begin or the last flush,
+        // sheet by sheet. Callers flush before drawing anything that has to
+        // stay on top of what was added so far.
+        void Flush();
+        // The last Flush of the frame.
+        void End() { this->Flush(); }
+
+        // Added since Begin, flushed or not.
+        size_t GetInstanceCount() const { return m_instances; }
+        bool HasPending() const { return m_pending > 0; }
+
+    private:
+        struct SheetBatch {
+            std::vector<float> positions; // x, y per vertex
+            std::vector<float> texCoords; // corner of the frame, 0..1
+            std::vector<float> frames;    // age in seconds, first frame, frame count, fps
+            size_t count = 0;             // instances
+            size_t uploaded = 0;          // instances the VBO has room for
+            ofVbo vbo;
+        };
+        void setupGL();
+
+        std::vector<SheetBatch> m_sheets; // by sheet index
+        uint64_t m_tick = 0;
+        size_t m_instances = 0;
+        size_t m_pending = 0;
+        ofShader m_shader;
+        int m_frameAttribute = -1;
+        bool m_glReady = false;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed size single producer / single consumer ring. Push from one thread,
+// Pop from one other thread, no locks and no allocation. Capacity must be a
+// power of two; one slot is kept free to tell full from empty.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    public:
+        // Producer side. False when the queue is full.
+        bool Push(const T& item) {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            const size_t next = (tail + 1) & (Capacity - 1);
+            if (next == m_head.load(std::memory_order_acquire)) { return false; }
+            m_items[tail] = item;
+            m_tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. False when the queue is empty.
+        bool Pop(T& out) {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire)) { return false; }
+            out = m_items[head];
+            m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::array<T, Capacity> m_items;
+        // on separate cache lines so the two threads don't fight over one
+        alignas(64) std::atomic<size_t> m_head{0};
+        alignas(64) std::atomic<size_t> m_tail{0};
+};
@@ -0,0 +1,113 @@
+#include "TaskGraph.h"
+#include <algorithm>
+#include <cstdio>
+#include "ofMain.h"
+
+TaskGraph::TaskId TaskGraph::Add(const char* name, std::function<void()> fn, std::initializer_list<TaskId> after) {
+    TaskId id = TaskId(m_nodes.size());
+    auto node = std::make_unique<Node>();
+    node->fn = std::move(fn);
+    node->timing.name = name;
+    for (TaskId before : after) {
+        if (before < 0 || before >= id) {
+            ofLogError() << "task '" << name << "' can only run after tasks added before it";
+            continue;
+        }
+        m_nodes[size_t(before)]->next.push_back(id);
+        ++node->dependencies;
+    }
+    m_nodes.push_back(std::move(node));
+    return id;
+}
+
+void TaskGraph::runNode(TaskId task) {
+    using Ms = std::chrono::duration<double, std::milli>;
+    // whatever becomes ready last is run right here instead of being queued
+    while (task >= 0) {
+        Node& node = *m_nodes[size_t(task)];
+        node.timing.startMs = Ms(std::chrono::steady_clock::now() - m_runStart).count();
+        node.fn();
+        node.timing.endMs = Ms(std::chrono::steady_clock::now() - m_runStart).count();
+        node.timing.worker = m_scheduler ? m_scheduler->GetCurrentWorker() : 0;
+        double ms = node.timing.endMs - node.timing.startMs;
+        node.timing.avgMs = node.timing.avgMs == 0.0 ? ms : node.timing.avgMs + (ms - node.timing.avgMs) * 0.05;
+        if (!m_scheduler) { return; } // serial, Run walks the tasks in order
+
+        TaskId continueWith = -1;
+        for (TaskId next : node.next) {
+            if (m_nodes[size_t(next)]->waiting.fetch_sub(1, std::memory_order_acq_rel) != 1) { continue; }
+            if (continueWith < 0) {
+                continueWith = next;
+            } else {
+                m_scheduler->Spawn(*m_group, [this, next] { this->runNode(next); });
+            }
+        }
+        task = continueWith;
+    }
+}
+
+void TaskGraph::Run(TaskScheduler* scheduler) {
+    m_runStart = std::chrono::steady_clock::now();
+    for (auto& node : m_nodes) {
+        node->waiting.store(node->dependencies, std::memory_order_relaxed);
+    }
+
+    if (!scheduler) {
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            this->runNode(TaskId(i));
+        }
+    } else {
+        TaskScheduler::TaskGroup group;
+        m_scheduler = scheduler;
+        m_group = &group;
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i]->dependencies == 0) {
+                TaskId root = TaskId(i);
+                scheduler->Spawn(group, [this, root] { this->runNode(root); });
+            }
+        }
+        scheduler->Wait(group);
+        m_scheduler = nullptr;
+        m_group = nullptr;
+    }
+    m_lastRunMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_runStart).count();
+}
+
+float TaskGraph::DrawTimeline(float x, float y, float width) const {
+    const float laneHeight = 14.0f;
+    int lanes = 1;
+    for (const auto& node : m_nodes) { lanes = std::max(lanes, node->timing.worker + 1); }
+    const float scale = m_lastRunMs > 0.0 ? float(width / m_lastRunMs) : 0.0f;
+
+    ofPushStyle();
+    ofSetColor(0, 0, 0, 160);
+    ofDrawRectangle(x, y, width, lanes * laneHeight);
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const TaskTiming& timing = m_nodes[i]->timing;
+        float left = x + float(timing.startMs) * scale;
+        float right = x + float(timing.endMs) * scale;
+        float top = y + timing.worker * laneHeight;
+        ofSetColor(ofColor::fromHsb(float((i * 47) % 255), 160, 220));
+        ofDrawRectangle(left, top + 1, std::max(right - left, 1.0f), laneHeight - 2);
+        ofSetColor(ofColor::black);
+        ofDrawBitmapString(timing.name, left + 2, top + laneHeight - 3);
+    }
+    ofPopStyle();
+
+    char line[64];
+    std::snprintf(line, sizeof(line), "frame graph %.2f ms on %d thread(s)", m_lastRunMs, lanes);
+    ofDrawBitmapStringHighlight(line, x, y + lanes * laneHeight + 14);
+    return y + lanes * laneHeight + 30;
+}
+
+void TaskGraph::PrintTimings(std::ostream& out) const {
+    char line[128];
+    std::snprintf(line, sizeof(line), "[frame graph] last run %.3f ms", m_lastRunMs);
+    out << line << std::endl;
+    for (const auto& node : m_nodes) {
+        const TaskTiming& timing = node->timing;
+        std::snprintf(line, sizeof(line), "  %-14s avg %.3f ms  last %.3f - %.3f ms  worker %d", timing.name, timing.avgMs,
+                      timing.startMs, timing.endMs, timing.worker);
+        out << line << std::endl;
+    }
+}
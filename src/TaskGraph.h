@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "TaskScheduler.h"
+
+// A fixed set of tasks with "runs after" edges, built once and run every
+// frame. Each task is handed to the scheduler the moment the last task it
+// waits on finishes, so branches of the graph overlap on idle cores. Every
+// run records when each task started and ended and on which worker, which
+// DrawTimeline shows as one lane per worker.
+class TaskGraph {
+    public:
+        using TaskId = int;
+
+        struct TaskTiming {
+            const char* name = "";
+            double startMs = 0.0;   // from the start of the last run
+            double endMs = 0.0;
+            double avgMs = 0.0;     // duration, moving average
+            int worker = 0;
+        };
+
+        // `after` must be tasks added earlier, so adding order is always a
+        // valid serial order. The name must outlive the graph (literals).
+        TaskId Add(const char* name, std::function<void()> fn, std::initializer_list<TaskId> after = {});
+        void Clear() { m_nodes.clear(); }
+
+        // Runs every task once and returns when all have finished. Without
+        // a scheduler the tasks run in the order they were added.
+        void Run(TaskScheduler* scheduler);
+
+        size_t GetTaskCount() const { return m_nodes.size(); }
+        const TaskTiming& GetTiming(TaskId task) const { return m_nodes[size_t(task)]->timing; }
+        double GetLastRunMs() const { return m_lastRunMs; }
+
+        // Bars for the last run, `width` pixels for the whole of it.
+        // Returns the y below the last lane.
+        float DrawTimeline(float x, float y, float width) const;
+        void PrintTimings(std::ostream& out) const;
+
+    private:
+        struct Node {
+            std::function<void()> fn;
+            std::vector<TaskId> next;
+            int dependencies = 0;
+            std::atomic<int> waiting{0};
+            TaskTiming timing;
+        };
+        void runNode(TaskId task);
+
+        std::vector<std::unique_ptr<Node>> m_nodes;
+        std::chrono::steady_clock::time_point m_runStart;
+        double m_lastRunMs = 0.0;
+        // only set while Run is going, so a spawned task captures just
+        // `this` and an id and std::function keeps it inline (no new)
+        TaskScheduler* m_scheduler = nullptr;
+        TaskScheduler::TaskGroup* m_group = nullptr;
+};
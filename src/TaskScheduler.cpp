@@ -0,0 +1,113 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include "Trace.h"
+
+namespace {
+// which scheduler the current thread works for, and its deque there
+thread_local const TaskScheduler* t_scheduler = nullptr;
+thread_local size_t t_queue = 0;
+}
+
+TaskScheduler::TaskScheduler(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // the waiting thread is one of the workers, it helps instead of sleeping
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 1; i < threadCount; ++i) {
+        m_threads.emplace_back(&TaskScheduler::workerLoop, this, size_t(i));
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::Shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+size_t TaskScheduler::queueIndex() const {
+    return t_scheduler == this ? t_queue : 0;
+}
+
+int TaskScheduler::GetCurrentWorker() const {
+    return int(this->queueIndex());
+}
+
+void TaskScheduler::Spawn(TaskGroup& group, Task task) {
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    WorkQueue& queue = *m_queues[this->queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{std::move(task), &group});
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    // taking the lock orders this against a worker checking m_queued
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+bool TaskScheduler::tryRunOne(size_t self) {
+    Job job;
+    bool found = false;
+    {
+        // own work first, newest first, it's the warmest in cache
+        WorkQueue& own = *m_queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            found = true;
+        }
+    }
+    for (size_t i = 1; i < m_queues.size() && !found; ++i) {
+        // then the oldest job of the next busy deque along
+        WorkQueue& victim = *m_queues[(self + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            found = true;
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (!found) { return false; }
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    job.fn();
+    job.group->m_pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void TaskScheduler::Wait(TaskGroup& group) {
+    const size_t self = this->queueIndex();
+    while (!group.IsDone()) {
+        if (!this->tryRunOne(self)) {
+            // the rest is running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    t_scheduler = this;
+    t_queue = index;
+    Trace::SetThreadName("task worker");
+    while (true) {
+        if (this->tryRunOne(index)) { continue; }
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_acquire) > 0; });
+        if (m_stop) { return; }
+    }
+}
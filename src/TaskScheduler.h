@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing scheduler for coarse tasks (whole tanks, frame phases).
+// Every worker has its own deque: it pushes and pops at the back of its own
+// and, when that runs dry, steals from the front of someone else's. Tasks
+// spawned from a task land on the spawning worker's deque, so related work
+// stays on one core unless another one is idle. Threads outside the pool
+// share one extra deque.
+//
+// WorkerPool is still the thing for splitting one loop into chunks; this is
+// for independent jobs of uneven size.
+class TaskScheduler {
+    public:
+        using Task = std::function<void()>;
+
+        // Counts the unfinished tasks spawned into it. Reusable once done.
+        class TaskGroup {
+            public:
+                bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+            private:
+                friend class TaskScheduler;
+                std::atomic<int> m_pending{0};
+        };
+
+        explicit TaskScheduler(unsigned threadCount = 0);
+        ~TaskScheduler();
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        void Spawn(TaskGroup& group, Task task);
+        // Runs queued tasks (any group's) until `group` is done. Fine to call
+        // from inside a task.
+        void Wait(TaskGroup& group);
+
+        // Including the thread that calls Wait.
+        unsigned GetThreadCount() const { return static_cast<unsigned>(m_threads.size()) + 1; }
+        // 0 for threads outside this scheduler, 1.. for its workers.
+        int GetCurrentWorker() const;
+        uint64_t GetStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+
+        static TaskScheduler& Shared();
+
+    private:
+        struct Job {
+            Task fn;
+            TaskGroup* group = nullptr;
+        };
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        size_t queueIndex() const;
+        bool tryRunOne(size_t self);
+        void workerLoop(size_t index);
+
+        std::vector<std::unique_ptr<WorkQueue>> m_queues; // [0] is for outside threads
+        std::vector<std::thread> m_threads;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+        std::atomic<int> m_queued{0};
+        std::atomic<uint64_t> m_steals{0};
+        bool m_stop = false;
+};
@@ -0,0 +1,164 @@
+#include "Trace.h"
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscQueue.h"
+
+std::atomic<bool> Trace::s_recording{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    uint64_t ts;   // microseconds since Start()
+    uint64_t dur;
+    int64_t value;
+    char phase;    // 'X' complete, 'i' instant
+};
+
+// One per thread that ever traced. The owning thread pushes, the writer
+// pops. Buffers live until the program ends so the writer never races a
+// thread that has exited.
+struct ThreadBuffer {
+    uint32_t tid = 0;
+    std::atomic<const char*> name{nullptr}; // set by the owner, read by Stop()
+    SpscQueue<TraceEvent, 16384> events;
+    std::atomic<uint64_t> dropped{0};
+};
+
+std::mutex g_threadsMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_threads;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+Trace::Clock::time_point g_start;
+std::ofstream g_out;
+bool g_firstEvent = true;
+std::thread g_writer;
+std::mutex g_writerMutex;
+std::condition_variable g_writerWake;
+bool g_stopWriter = false;
+
+ThreadBuffer& LocalBuffer() {
+    if (t_buffer == nullptr) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(g_threadsMutex);
+        buffer->tid = uint32_t(g_threads.size() + 1);
+        t_buffer = buffer.get();
+        g_threads.push_back(std::move(buffer));
+    }
+    return *t_buffer;
+}
+
+uint64_t Micros(Trace::Clock::time_point t) {
+    if (t < g_start) { return 0; } // scope opened before recording started
+    return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(t - g_start).count());
+}
+
+void Push(const TraceEvent& event) {
+    ThreadBuffer& buffer = LocalBuffer();
+    if (!buffer.events.Push(event)) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void WriteEvent(const ThreadBuffer& thread, const TraceEvent& event) {
+    g_out << (g_firstEvent ? "\n" : ",\n");
+    g_firstEvent = false;
+    g_out << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"ts\":" << event.ts
+          << ",\"pid\":1,\"tid\":" << thread.tid;
+    if (event.phase == 'X') {
+        g_out << ",\"dur\":" << event.dur;
+    } else {
+        g_out << ",\"s\":\"t\",\"args\":{\"value\":" << event.value << "}";
+    }
+    g_out << "}";
+}
+
+// Writer thread only, or the caller of Stop() once the writer has joined.
+void Drain(bool write) {
+    std::vector<ThreadBuffer*> threads;
+    {
+        std::lock_guard<std::mutex> lock(g_threadsMutex);
+        for (auto& buffer : g_threads) { threads.push_back(buffer.get()); }
+    }
+    TraceEvent event;
+    for (ThreadBuffer* thread : threads) {
+        while (thread->events.Pop(event)) {
+            if (write) { WriteEvent(*thread, event); }
+        }
+    }
+}
+
+void WriterLoop() {
+    std::unique_lock<std::mutex> lock(g_writerMutex);
+    while (!g_stopWriter) {
+        g_writerWake.wait_for(lock, std::chrono::milliseconds(5));
+        lock.unlock();
+        Drain(true);
+        lock.lock();
+    }
+}
+
+}
+
+bool Trace::Start(const std::string& path) {
+    if (IsRecording()) { return false; }
+    g_out.open(path);
+    if (!g_out) { return false; }
+
+    Drain(false); // leftovers from a previous recording
+    g_out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    g_firstEvent = true;
+    g_start = Clock::now();
+    g_stopWriter = false;
+    g_writer = std::thread(WriterLoop);
+    s_recording.store(true);
+    return true;
+}
+
+void Trace::Stop() {
+    if (!IsRecording()) { return; }
+    s_recording.store(false);
+    {
+        std::lock_guard<std::mutex> lock(g_writerMutex);
+        g_stopWriter = true;
+    }
+    g_writerWake.notify_one();
+    g_writer.join();
+    Drain(true);
+
+    std::lock_guard<std::mutex> lock(g_threadsMutex);
+    for (auto& thread : g_threads) {
+        g_out << (g_firstEvent ? "\n" : ",\n");
+        g_firstEvent = false;
+        g_out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->tid
+              << ",\"args\":{\"name\":\"" << (thread->name.load() ? thread->name.load() : "thread") << " " << thread->tid << "\"}}";
+    }
+    g_out << "\n]}\n";
+    g_out.close();
+}
+
+void Trace::Complete(const char* name, Clock::time_point start, Clock::time_point end) {
+    if (!IsRecording()) { return; }
+    uint64_t ts = Micros(start);
+    Push(TraceEvent{name, ts, Micros(end) - ts, 0, 'X'});
+}
+
+void Trace::Instant(const char* name, int64_t value) {
+    if (!IsRecording()) { return; }
+    Push(TraceEvent{name, Micros(Clock::now()), 0, value, 'i'});
+}
+
+void Trace::SetThreadName(const char* name) {
+    LocalBuffer().name = name;
+}
+
+uint64_t Trace::GetDroppedCount() {
+    std::lock_guard<std::mutex> lock(g_threadsMutex);
+    uint64_t dropped = 0;
+    for (auto& thread : g_threads) { dropped += thread->dropped.load(); }
+    return dropped;
+}
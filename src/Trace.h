@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Chrome trace-event recorder; the JSON opens in Perfetto or
+// chrome://tracing. While recording, every PROFILE_SCOPE becomes a complete
+// ("X") event and gameplay code can add instant events. Each thread writes
+// into its own lock-free ring and a background thread drains the rings to
+// disk, so a traced frame only pays for a few stores per scope.
+class Trace {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static bool Start(const std::string& path);
+        static void Stop();
+        static bool IsRecording() { return s_recording.load(std::memory_order_acquire); }
+
+        static void Complete(const char* name, Clock::time_point start, Clock::time_point end);
+        static void Instant(const char* name, int64_t value = 0);
+
+        // Shows up as the thread's name in the viewer.
+        static void SetThreadName(const char* name);
+
+        // Events lost because a thread's ring was full.
+        static uint64_t GetDroppedCount();
+
+    private:
+        static std::atomic<bool> s_recording;
+};
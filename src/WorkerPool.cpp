@@ -0,0 +1,101 @@
+#include "WorkerPool.h"
+#include <algorithm>
+#include "Profiler.h"
+#include "Trace.h"
+
+namespace {
+thread_local bool t_insideWorker = false;
+}
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // the submitting thread counts as one of the workers
+    for (unsigned i = 1; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) {
+        t.join();
+    }
+}
+
+WorkerPool& WorkerPool::Shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+void WorkerPool::ParallelFor(size_t count, size_t grain, const RangeFn& fn) {
+    if (count == 0) { return; }
+    grain = std::max<size_t>(1, grain);
+
+    // too small to be worth waking anyone, or we are already on a worker
+    if (m_threads.empty() || count <= grain || t_insideWorker) {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_count = count;
+        m_grain = grain;
+        m_next = 0;
+        m_remaining = (count + grain - 1) / grain;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    t_insideWorker = true;
+    runChunks();
+    t_insideWorker = false;
+
+    // wait for the last chunk and for every worker to let go of m_fn
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_remaining == 0 && m_busyWorkers == 0; });
+    m_fn = nullptr;
+}
+
+void WorkerPool::runChunks() {
+    PROFILE_SCOPE("parallel for");
+    while (true) {
+        size_t begin = m_next.fetch_add(m_grain);
+        if (begin >= m_count) { return; }
+        size_t end = std::min(m_count, begin + m_grain);
+        (*m_fn)(begin, end);
+        if (m_remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    t_insideWorker = true;
+    Trace::SetThreadName("worker");
+    unsigned seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || (m_generation != seenGeneration && m_fn != nullptr); });
+            if (m_stop) { return; }
+            seenGeneration = m_generation;
+            ++m_busyWorkers;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busyWorkers;
+        }
+        m_done.notify_all();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small persistent thread pool for data-parallel loops. Threads are started
+// once and sleep between jobs, so a ParallelFor costs a wake-up instead of a
+// thread spawn. Calls made from inside a worker run inline on that worker.
+class WorkerPool {
+    public:
+        using RangeFn = std::function<void(size_t begin, size_t end)>;
+
+        explicit WorkerPool(unsigned threadCount = 0);
+        ~WorkerPool();
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Splits [0, count) into chunks of `grain` and blocks until all of
+        // them have run. The calling thread helps with the work.
+        void ParallelFor(size_t count, size_t grain, const RangeFn& fn);
+
+        unsigned GetThreadCount() const { return static_cast<unsigned>(m_threads.size()) + 1; }
+
+        static WorkerPool& Shared();
+
+    private:
+        void workerLoop();
+        void runChunks();
+
+        std::vector<std::thread> m_threads;
+        std::mutex m_submitMutex; // one job in flight at a time
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        const RangeFn* m_fn = nullptr;
+        size_t m_count = 0;
+        size_t m_grain = 1;
+        std::atomic<size_t> m_next{0};
+        std::atomic<size_t> m_remaining{0};
+        unsigned m_generation = 0;
+        int m_busyWorkers = 0;
+        bool m_stop = false;
+};
@@ -1,8 +1,47 @@
 #include "ofMain.h"
 #include "ofApp.h"
+#include "Benchmarks.h"
+#include "BalanceRunner.h"
+#include "GoldenFrames.h"
+#include "SoakRunner.h"
+#include "FixedSimulation.h"
 
 //========================================================================
-int main( ){
+int main(int argc, char* argv[]){
+
+	// Benchmarks are headless, skip the window entirely
+	if (argc > 1 && std::string(argv[1]) == "--bench") {
+		return RunBenchmarks(argc > 2 ? argv[2] : "all");
+	}
+	// Headless balancing games, also without a window
+	if (argc > 1 && std::string(argv[1]) == "--balance") {
+		BalanceOptions options;
+		if (argc > 2) { options.games = std::atoi(argv[2]); }
+		if (argc > 3) { options.threads = unsigned(std::atoi(argv[3])); }
+		return RunBalancing(options);
+	}
+	// Offscreen golden-frame checks and draw timings, hidden window
+	if (argc > 1 && std::string(argv[1]) == "--golden") {
+		GoldenOptions options;
+		options.update = argc > 2 && std::string(argv[2]) == "update";
+		return RunGoldenFrames(options);
+	}
+
+	// Headless bot soak, frame time and memory over hours
+	if (argc > 1 && std::string(argv[1]) == "--soak") {
+		SoakOptions options;
+		if (argc > 2) { options.bot = argv[2]; }
+		if (argc > 3) { options.minutes = std::atof(argv[3]); }
+		return RunSoak(options);
+	}
+
+	// Fixed point replay, prints the hashes to compare between builds
+	if (argc > 1 && std::string(argv[1]) == "--fixed") {
+		FixedReplayOptions options;
+		if (argc > 2) { options.seed = uint32_t(std::atoi(argv[2])); }
+		if (argc > 3) { options.ticks = std::atoi(argv[3]); }
+		return RunFixedReplay(options);
+	}
 
 	//Use ofGLFWWindowSettings for more options like multi-monitor fullscreen
 	ofGLWindowSettings settings;
@@ -11,7 +50,17 @@ int main( ){
 
 	auto window = ofCreateWindow(settings);
 
-	ofRunApp(window, std::make_shared<ofApp>());
+	auto app = std::make_shared<ofApp>();
+	// Same game in a window with a bot at the controls
+	if (argc > 2 && std::string(argv[1]) == "--bot") {
+		app->botName = argv[2];
+		if (argc > 3) { app->botMinutes = std::atof(argv[3]); }
+	}
+	// Split screen, bots play the other tanks
+	if (argc > 2 && std::string(argv[1]) == "--tanks") {
+		app->tankCount = std::max(1, std::atoi(argv[2]));
+	}
+	ofRunApp(window, app);
 	ofRunMainLoop();
 
 }
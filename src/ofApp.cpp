@@ -4,48 +4,91 @@
 void ofApp::setup(){
 
     ofSetFrameRate(60);
+    pacer.SetTargetFps(60);
     ofSetBackgroundColor(ofColor::blue);
-    backgroundImage.load("background.png");
-    backgroundImage.resize(ofGetWindowWidth(), ofGetWindowHeight());
+    backgroundImage.load("background.png"); // kept at its own size, the GPU scales it
+    worldView.SetTargetSize(ofGetWindowWidth(), ofGetWindowHeight());
 
 
     std::shared_ptr<Aquarium> myAquarium;
     std::shared_ptr<PlayerCreature> player;
 
+    // Level definitions, fall back to the built-in ones if settings.xml is unusable
+    std::string settingsPath = ofToDataPath("settings.xml", true);
+    std::string levelError;
+    if (!LevelTable::LoadFromXml(settingsPath, levelTable, levelError)) {
+        ofLogError() << "Using built-in levels: " << levelError;
+        levelTable = LevelTable::Defaults();
+    }
+    DEFAULT_SPEED = levelTable.playerSpeed;
+    levelWatcher = std::make_unique<LevelTableWatcher>(settingsPath);
+
     // make the game scene manager 
     gameManager = std::make_unique<GameSceneManager>();
+    gameManager->SetEventBus(&eventBus);
 
 
     // first we make the intro scene 
     gameManager->AddScene(std::make_shared<GameIntroScene>(
         GameSceneKindToString(GameSceneKind::GAME_INTRO),
-        std::make_shared<GameSprite>("title.png", ofGetWindowWidth(), ofGetWindowHeight())
+        std::make_shared<GameSprite>("title.png", WorldWidth, WorldHeight)
     ));
 
+    // Sprite sheets and their animations, creatures without one keep their plain sprite
+    std::string animationError;
+    if (AnimationTable::LoadFromXml(ofToDataPath("animations.xml", true), animationError)) {
+        AnimationTable::LoadTextures();
+    } else {
+        ofLogError() << "No sprite animations: " << animationError;
+    }
+
     //AquariumSpriteManager
     spriteManager = std::make_shared<AquariumSpriteManager>();
 
     // Lets setup the aquarium
-    myAquarium = std::make_shared<Aquarium>(ofGetWindowWidth(), ofGetWindowHeight(), spriteManager);
-    player = std::make_shared<PlayerCreature>(ofGetWindowWidth()/2 - 50, ofGetWindowHeight()/2 - 50, DEFAULT_SPEED, this->spriteManager->GetPlayerSprite(PlayerType::Pirahna));
+    myAquarium = std::make_shared<Aquarium>(WorldWidth, WorldHeight, spriteManager);
+    player = std::make_shared<PlayerCreature>(WorldWidth/2 - 50, WorldHeight/2 - 50, DEFAULT_SPEED, this->spriteManager->GetPlayerSprite(PlayerType::Pirahna));
 
-    player->setBounds(ofGetWindowWidth() - 20, ofGetWindowHeight() - 20);
-    
-    // Add player instance to the static Creature class
-    Creature::SetPlayer(player);
-
-    myAquarium->addAquariumLevel(std::make_shared<Level_0>(0, 10));
-    myAquarium->addAquariumLevel(std::make_shared<Level_1>(1, 15));
-    myAquarium->addAquariumLevel(std::make_shared<Level_2>(2, 15));
-    myAquarium->addAquariumLevel(std::make_shared<Level_3>(3, 20));
-    myAquarium->addAquariumLevel(std::make_shared<Level_4>(4, 20));
-    myAquarium->addAquariumLevel(std::make_shared<Level_5>(5, 25));
+
+    myAquarium->setLevelTable(levelTable);
     myAquarium->Repopulate(); // initial population
 
     // now that we are mostly set, lets pass the player and the aquarium downstream
-    gameManager->AddScene(std::make_shared<AquariumGameScene>(
+    auto aquariumScene = std::make_shared<AquariumGameScene>(
         std::move(player), std::move(myAquarium), GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)
-    )); // player and aquarium are owned by the scene moving forward
+    ); // player and aquarium are owned by the scene moving forward
+    aquariumScene->SetEventBus(&eventBus);
+    aquariumScene->SetScheduler(&TaskScheduler::Shared());
+    if(!botName.empty()){
+        bot = MakeBot(botName, 1);
+        if(!bot){
+            ofLogError() << "unknown bot '" << botName << "', pick one of: " << BotNames();
+        }
+    }
+    aquariumScene->SetController(bot ? bot.get() : &human);
+    gameManager->AddScene(aquariumScene);
+
+    // effects for gameplay events, the particles never feed back into the game
+    ParticleSystem* particles = &aquariumScene->GetParticles();
+    eventBus.Subscribe(GameEventType::CREATURE_REMOVED, [particles](const GameEvent& event){
+        particles->Emit(ParticleEffect::Eat, event.x, event.y);
+    });
+    eventBus.Subscribe(GameEventType::POWER_UP, [particles](const GameEvent& event){
+        particles->Emit(ParticleEffect::PowerUp, event.x, event.y);
+    });
+    eventBus.Subscribe(GameEventType::PLAYER_HURT, [particles](const GameEvent& event){
+        particles->Emit(ParticleEffect::Hurt, event.x, event.y);
+    });
+
+    // the scene tells us when the player is out of lives, bots just go again
+    eventBus.Subscribe(GameEventType::GAME_OVER, [this, aquariumScene](const GameEvent&){
+        if(bot){
+            if(soak){ soak->GameFinished(aquariumScene->GetPlayer()->getScore(), aquariumScene->GetAquarium()->getCurrentLevel()); }
+            aquariumScene->Restart();
+            return;
+        }
+        gameManager->Transition(GameSceneKindToString(GameSceneKind::GAME_OVER));
+    });
 
     // Load font for game over message
     gameOverTitle.load("Verdana.ttf", 12, true, true);
@@ -55,37 +98,90 @@ void ofApp::setup(){
 
     gameManager->AddScene(std::make_shared<GameOverScene>(
         GameSceneKindToString(GameSceneKind::GAME_OVER),
-        std::make_shared<GameSprite>("game-over.png", ofGetWindowWidth(), ofGetWindowHeight())
+        std::make_shared<GameSprite>("game-over.png", WorldWidth, WorldHeight)
     ));
 
-    // Background ambience
-    if (!ambient.load("audio/ambient.mp3"))
+    // Background ambience is streamed, effects are mixed on the audio thread
+    audio.Setup();
+    if (!audio.StartAmbient("audio/ambient.mp3", 0.45f))
         ofLogError() << "Failed to load ambient.mp3!";
-    ambient.setLoop(true);
-    ambient.setMultiPlay(false);
-    ambient.setVolume(0.45f);
-    ambient.play();
+    eventBus.Subscribe(GameEventType::CREATURE_REMOVED, [this](const GameEvent&){ audio.Play(SoundEffect::Eat); });
+    eventBus.Subscribe(GameEventType::PLAYER_HURT, [this](const GameEvent&){ audio.Play(SoundEffect::Hurt); });
+    eventBus.Subscribe(GameEventType::POWER_UP, [this](const GameEvent&){ audio.Play(SoundEffect::PowerUp); });
+    eventBus.Subscribe(GameEventType::NEW_LEVEL, [this](const GameEvent&){ audio.Play(SoundEffect::LevelUp); });
+
+    // the gameplay loop should not touch the heap once it is running,
+    // spawning on repopulate is the only expected source
+    for (const char* scope : {"simulate", "collisions", "schooling", "move", "chains", "events", "particles", "hud"}) {
+        Profiler::SetAllocationBudget(scope, 0);
+    }
+
+    if(tankCount > 1){
+        spectators = std::make_unique<AquariumManager>();
+        spectators->SetRestartOnGameOver(true);
+        for(int i = 1; i < tankCount; ++i){
+            spectators->AddTank(levelTable, uint32_t(100 + i), MakeBot("avoid", uint32_t(i)), spriteManager);
+        }
+        worldView.SetTarget(getTile(0));
+    }
+
+    if(bot){
+        soak = std::make_unique<SoakMonitor>();
+        std::string csvPath = ofToDataPath("soak-" + ofGetTimestampString() + ".csv", true);
+        if(!soak->Open(csvPath)){ ofLogError() << "could not open " << csvPath; }
+        gameManager->Transition(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME));
+    }
+
+    Trace::SetThreadName("main");
+    updateScope = Profiler::RegisterScope("update");
+    drawScope = Profiler::RegisterScope("draw");
+    applyQuality();
 
     ofSetLogLevel(OF_LOG_NOTICE); // Set default log level
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
-    
+    Profiler::NextFrame();
+    input.PollGamepad(ofGetElapsedTimeMicros());
+    if(soak){
+        // whole frame, vsync wait included, that is what a player would see
+        soak->Frame(ofGetLastFrameTime() * 1000.0, ofGetElapsedTimef());
+        if(botMinutes > 0 && ofGetElapsedTimef() > botMinutes * 60.0){
+            soak->Finish(ofGetElapsedTimef());
+            soak.reset();
+            ofExit();
+            return;
+        }
+    }
+    // last frame's update and draw, as the profiler measured them
+    if(pacer.Observe(Profiler::GetLastFrame(updateScope).micros, Profiler::GetLastFrame(drawScope).micros)){
+        applyQuality();
+        ofLogNotice() << "quality " << pacer.GetQuality().name << ", frames averaged "
+                      << pacer.GetAverageMs() << " ms of a " << pacer.GetBudgetMs() << " ms budget";
+    }
+    PROFILE_SCOPE("update");
+
     if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::GAME_OVER)){
         return; // Stop updating if game is over or exiting
     }
 
-    if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
-        auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
-        if(gameScene->GetLastEvent() != nullptr && gameScene->GetLastEvent()->isGameOver()){
-            gameManager->Transition(GameSceneKindToString(GameSceneKind::GAME_OVER));
-            return;
-        }
-        
+    // hot reload happens here, between two ticks, never in the middle of one
+    if(levelWatcher->Poll(levelTable)){
+        auto aquariumScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+        aquariumScene->GetAquarium()->setLevelTable(levelTable);
+        if(spectators){ spectators->SetLevelTable(levelTable); }
     }
 
+    // the other tanks tick on the workers while ours runs here
+    bool inGame = gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME);
+    if(spectators && inGame){ spectators->Launch(); }
     gameManager->UpdateActiveScene();
+    if(spectators && inGame){ spectators->Wait(); }
+
+    // everything published this frame (hits, power ups, game over...) goes out here
+    PROFILE_SCOPE("events");
+    eventBus.Dispatch();
     
 
 
@@ -93,25 +189,124 @@ void ofApp::update(){
 
 //--------------------------------------------------------------
 void ofApp::draw(){
-    backgroundImage.draw(0, 0);
-    gameManager->DrawActiveScene();
+    {
+        PROFILE_SCOPE("draw");
+        worldView.Begin();
+        if(pacer.GetQuality().drawBackground){
+            backgroundImage.draw(0, 0, WorldWidth, WorldHeight); // otherwise the plain blue clear color shows
+        }
+        gameManager->DrawActiveScene();
+        worldView.End();
+        if(spectators && gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
+            PROFILE_SCOPE("draw tanks");
+            const ofImage* background = pacer.GetQuality().drawBackground ? &backgroundImage : nullptr;
+            for(size_t i = 0; i < spectators->GetTankCount(); ++i){
+                spectators->DrawTank(i, getTile(i + 1), background);
+            }
+        }
+    }
+    if(showProfiler){
+        PROFILE_SCOPE("profiler overlay"); // it formats strings, keep that out of "draw"
+        float y = Profiler::DrawOverlay(10, 20);
+        char line[128];
+        std::snprintf(line, sizeof(line), "quality %s%s  budget %.1f ms  update %.2f + draw %.2f ms (avg %.2f)",
+                      pacer.GetQuality().name, pacer.IsAdaptive() ? "" : " (pinned)", pacer.GetBudgetMs(),
+                      pacer.GetUpdateMs(), pacer.GetDrawMs(), pacer.GetAverageMs());
+        ofDrawBitmapStringHighlight(line, 10, y);
+        InputState::Latency latency = input.GetLatency();
+        std::snprintf(line, sizeof(line), "input to sim avg %.2f ms  max %.2f ms  (%llu samples)",
+                      latency.avgMs, latency.maxMs, (unsigned long long)latency.samples);
+        ofDrawBitmapStringHighlight(line, 10, y + 16);
+        if(spectators){
+            std::snprintf(line, sizeof(line), "%zu other tanks  step %.2f ms on %u threads", spectators->GetTankCount(),
+                          spectators->GetLastStepMs(), TaskScheduler::Shared().GetThreadCount());
+            ofDrawBitmapStringHighlight(line, 10, y + 32);
+        }
+        auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+        const PredatorCullStats& cull = gameScene->GetAquarium()->getPredatorCullStats();
+        std::snprintf(line, sizeof(line), "predator bounds %.1f%% culled, %.1f%% of the rest missed  (%llu checks)",
+                      cull.CullRate() * 100.0, cull.FalsePositiveRate() * 100.0, (unsigned long long)(cull.culled + cull.tested));
+        ofDrawBitmapStringHighlight(line, 10, y + 48);
+        gameScene->GetFrameGraph().DrawTimeline(10, y + 68, 400);
+    }
+}
+
+ofRectangle ofApp::getTile(size_t tank) const{
+    return AquariumManager::GetTile(tank, size_t(tankCount), ofRectangle(0, 0, ofGetWindowWidth(), ofGetWindowHeight()));
+}
+
+void ofApp::applyQuality(){
+    auto aquariumScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+    aquariumScene->SetQuality(pacer.GetQuality());
 }
 
 //--------------------------------------------------------------
 void ofApp::exit(){
-    
+    if(soak){ soak->Finish(ofGetElapsedTimef()); }
+    Trace::Stop();
+    if(Profiler::TracksAllocations){
+        Profiler::WriteReport(ofToDataPath("profile.txt"));
+    }
+    logAudioStats();
+    if(spectators){ spectators->PrintTimings(std::cout); }
+    auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+    gameScene->GetFrameGraph().PrintTimings(std::cout);
+    InputState::Latency latency = input.GetLatency();
+    ofLogNotice() << "input: " << latency.samples << " samples, key to sim avg " << latency.avgMs
+                  << " ms max " << latency.maxMs << " ms, " << latency.dropped << " dropped";
+    audio.Close();
+}
+
+void ofApp::toggleTrace(){
+    if(Trace::IsRecording()){
+        Trace::Stop();
+        ofLogNotice() << "trace stopped, " << Trace::GetDroppedCount() << " events dropped";
+        return;
+    }
+    std::string path = ofToDataPath("trace-" + ofGetTimestampString() + ".json");
+    if(Trace::Start(path)){
+        ofLogNotice() << "tracing to " << path << ", F7 again to stop";
+    }
+    else{
+        ofLogError() << "could not open " << path;
+    }
+}
+
+void ofApp::logAudioStats(){
+    AudioEngine::Stats stats = audio.GetStats();
+    ofLogNotice() << "audio: " << stats.played << " effects played, latency avg " << stats.avgLatencyMs
+                  << " ms max " << stats.maxLatencyMs << " ms, " << stats.stolen << " voices stolen, "
+                  << stats.queueFull << " dropped, memory " << (stats.effectBytes + stats.voiceBytes) / 1024 << " KB";
 }
 
 //--------------------------------------------------------------
 void ofApp::keyPressed(int key){
+    // every key lands in the input state, the scene decides what it means
+    input.KeyPressed(key, ofGetElapsedTimeMicros());
+    if(key == OF_KEY_F2){ showProfiler = !showProfiler; return; }
+    if(key == OF_KEY_F7){ toggleTrace(); return; }
+    if(key == OF_KEY_F8){
+        pacer.SetAdaptive(!pacer.IsAdaptive());
+        ofLogNotice() << "quality " << pacer.GetQuality().name << (pacer.IsAdaptive() ? ", adaptive" : ", pinned");
+        return;
+    }
+    if(key == OF_KEY_F6){
+        std::string path = ofToDataPath("profile.txt");
+        if(Profiler::WriteReport(path)){ ofLogNotice() << "profile written to " << path; }
+        return;
+    }
     if (lastEvent.isGameExit()) { 
         ofLogNotice() << "Game has ended. Press ESC to exit." << std::endl;
         return; // Ignore other keys after game over
     }
     if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
         auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
-        
-        gameScene->keysDown[key] = true;
+
+        if(key == OF_KEY_F5){ saveCheckpoint(); return; }
+        if(key == OF_KEY_F9){ loadCheckpoint(); return; }
+        if(key == OF_KEY_F4){ logAudioStats(); return; }
+        if(key == OF_KEY_F10){ AquariumMemory::Print(AquariumMemory::Measure(*gameScene->GetAquarium()), std::cout); return; }
+        if(key == OF_KEY_F3){ gameScene->GetHud().SetShowFps(!gameScene->GetHud().IsShowingFps()); return; }
         return;
 
     }
@@ -135,12 +330,30 @@ void ofApp::keyPressed(int key){
 
 //--------------------------------------------------------------
 void ofApp::keyReleased(int key){
-    if(gameManager->GetActiveSceneName() == GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)){
-        auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetActiveScene());
-        
-        gameScene->keysDown[key] = false;
+    input.KeyReleased(key, ofGetElapsedTimeMicros());
+}
 
+//--------------------------------------------------------------
+void ofApp::saveCheckpoint(){
+    auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+    uint64_t start = ofGetElapsedTimeMicros();
+    if(!AquariumSnapshot::SaveToFile(ofToDataPath("checkpoint.aqsn", true), *gameScene->GetAquarium(), *gameScene->GetPlayer(), snapshotBuffer)){
+        ofLogError() << "Failed to write checkpoint";
+        return;
+    }
+    ofLogNotice() << "Checkpoint saved (" << snapshotBuffer.size() << " bytes, " << ofGetElapsedTimeMicros() - start << " us)";
+}
+
+//--------------------------------------------------------------
+void ofApp::loadCheckpoint(){
+    auto gameScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
+    std::string error;
+    uint64_t start = ofGetElapsedTimeMicros();
+    if(!AquariumSnapshot::LoadFromFile(ofToDataPath("checkpoint.aqsn", true), *gameScene->GetAquarium(), *gameScene->GetPlayer(), snapshotBuffer, error)){
+        ofLogError() << "Failed to load checkpoint: " << error;
+        return;
     }
+    ofLogNotice() << "Checkpoint loaded (" << snapshotBuffer.size() << " bytes, " << ofGetElapsedTimeMicros() - start << " us)";
 }
 
 //--------------------------------------------------------------
@@ -180,11 +393,9 @@ void ofApp::mouseExited(int x, int y){
 
 //--------------------------------------------------------------
 void ofApp::windowResized(int w, int h){
-    backgroundImage.resize(w, h);
-    auto aquariumScene = std::static_pointer_cast<AquariumGameScene>(gameManager->GetScene(GameSceneKindToString(GameSceneKind::AQUARIUM_GAME)));
-    aquariumScene->GetAquarium()->setBounds(w,h);
-    aquariumScene->GetPlayer()->setBounds(w - 20, h - 20);
-
+    // the world keeps its size, only where it lands in the window changes
+    if(spectators){ worldView.SetTarget(getTile(0)); }
+    else{ worldView.SetTargetSize(w, h); }
 }
 
 //--------------------------------------------------------------
@@ -2,6 +2,14 @@
 
 #include "ofMain.h"
 #include "Aquarium.h"
+#include "AquariumSnapshot.h"
+#include "AudioEngine.h"
+#include "Profiler.h"
+#include "FramePacer.h"
+#include "Bots.h"
+#include "SoakRunner.h"
+#include "MemoryReport.h"
+#include "AquariumManager.h"
 
 
 class ofApp : public ofBaseApp{
@@ -33,10 +41,47 @@ class ofApp : public ofBaseApp{
 
 		ofTrueTypeFont gameOverTitle;
 		GameEvent lastEvent;
+		GameEventBus eventBus;
 
 
 		ofImage backgroundImage;
-		ofSoundPlayer ambient;
+		WorldView worldView; // world units to window pixels, letterboxed
+		AudioEngine audio;
+		void logAudioStats(); // F4
+
+		bool showProfiler = false; // F2, F6 writes profile.txt
+		// turns quality down when frames run long, F8 pins the current level
+		FramePacer pacer{60};
+		int updateScope = 0;
+		int drawScope = 0;
+		void applyQuality();
+		void toggleTrace(); // F7, writes a Chrome trace for Perfetto
+
+		// keyboard and gamepad, rebind through input.GetActionMap()
+		InputState input;
+		HumanController human{input};
+
+		// --bot <name> [minutes]: a bot plays instead, game after game, and
+		// frame time and memory go to soak-<time>.csv; 0 minutes runs until closed
+		std::string botName;
+		double botMinutes = 0;
+		std::unique_ptr<PlayerController> bot;
+		std::unique_ptr<SoakMonitor> soak;
+
+		// --tanks <n>: n - 1 bot tanks play next to yours, tiled over the
+		// window and ticked alongside it on the task scheduler
+		int tankCount = 1;
+		std::unique_ptr<AquariumManager> spectators;
+		ofRectangle getTile(size_t tank) const;
+
+		// levels live in settings.xml and are reloaded when the file changes
+		LevelTable levelTable;
+		std::unique_ptr<LevelTableWatcher> levelWatcher;
+
+		// F5 saves a checkpoint, F9 restores it
+		void saveCheckpoint();
+		void loadCheckpoint();
+		std::vector<uint8_t> snapshotBuffer;
 
 		std::unique_ptr<GameSceneManager> gameManager;
 		std::shared_ptr<AquariumSpriteManager>spriteManager;